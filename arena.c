@@ -0,0 +1,158 @@
+#if !defined(_WIN32)
+    #define _POSIX_C_SOURCE 200112L     // sysconf under -std=c11
+    #include <unistd.h>
+#endif
+#include "arena.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(PLATFORM_WEB)
+    #define ARENA_THREADS 0
+#else
+    #define ARENA_THREADS 1
+    #include <pthread.h>
+#endif
+
+#define ARENA_MAX_WORKERS (ARENA_MAX - 1)
+
+// ------------------- Arena -------------------
+void ArenaQueueEvent(void *arena, const SimEvent *event){
+    Arena *a = arena;
+    if(a->eventCount == ARENA_MAX_EVENTS){
+        a->eventsDropped++;
+        return;
+    }
+    a->events[a->eventCount++] = *event;
+}
+
+void ArenaHitAt(Arena *a, double time, int hole, int team){
+    if(SimIsOver(&a->match) || a->hitCount == ARENA_MAX_HITS) return;
+    a->hits[a->hitCount++] = (ArenaHit){ time, (uint16_t)hole, (uint8_t)team };
+}
+
+// Each tick takes the hits struck before it ended, in the order they came in
+static void Advance(Arena *a, double now){
+    if(now - a->simClock > 0.25) a->simClock = now - 0.25;   // long hitch: drop time rather than spiral
+    while(a->simClock + SIM_DT <= now && !SimIsOver(&a->match)){
+        SimInput input = {0};
+        int kept = 0;
+        for(int i=0;i<a->hitCount;i++){
+            if(a->hits[i].time < a->simClock + SIM_DT) SimInputAdd(&input, a->hits[i].hole, a->hits[i].team);
+            else a->hits[kept++] = a->hits[i];
+        }
+        a->hitCount = kept;
+        SimStep(&a->match, &input);
+        a->simClock += SIM_DT;
+    }
+    if(SimIsOver(&a->match)) a->hitCount = 0;
+}
+
+// ------------------- Pool -------------------
+#if ARENA_THREADS
+// Workers sleep on a generation counter; each frame bumps it and everyone,
+// the caller included, takes arenas off a shared index until none are left
+static struct {
+    pthread_t threads[ARENA_MAX_WORKERS];
+    int workerCount;
+    pthread_mutex_t lock;
+    pthread_cond_t wake, done;
+    unsigned generation;
+    int busy;                   // workers still on this generation
+    bool quit;
+
+    Arena *arenas;
+    int count;
+    double now;
+    atomic_int next;
+} pool;
+
+static void RunTasks(void){
+    int i;
+    while((i = atomic_fetch_add(&pool.next, 1)) < pool.count) Advance(&pool.arenas[i], pool.now);
+}
+
+static void *WorkerMain(void *arg){
+    (void)arg;
+    unsigned seen = 0;
+    pthread_mutex_lock(&pool.lock);
+    for(;;){
+        while(pool.generation == seen && !pool.quit) pthread_cond_wait(&pool.wake, &pool.lock);
+        if(pool.quit) break;
+        seen = pool.generation;
+        pthread_mutex_unlock(&pool.lock);
+        RunTasks();
+        pthread_mutex_lock(&pool.lock);
+        if(--pool.busy == 0) pthread_cond_signal(&pool.done);
+    }
+    pthread_mutex_unlock(&pool.lock);
+    return NULL;
+}
+
+void ArenaPoolStart(int workers){
+    if(workers > ARENA_MAX_WORKERS) workers = ARENA_MAX_WORKERS;
+    if(workers <= 0 || pool.workerCount > 0) return;
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_cond_init(&pool.wake, NULL);
+    pthread_cond_init(&pool.done, NULL);
+    pool.quit = false;
+    for(int i=0;i<workers;i++){
+        if(pthread_create(&pool.threads[i], NULL, WorkerMain, NULL) != 0) break;
+        pool.workerCount++;
+    }
+    fprintf(stderr, "ARENA: %d stepping threads besides the main one\n", pool.workerCount);
+}
+
+void ArenaPoolStop(void){
+    if(pool.workerCount == 0) return;
+    pthread_mutex_lock(&pool.lock);
+    pool.quit = true;
+    pthread_cond_broadcast(&pool.wake);
+    pthread_mutex_unlock(&pool.lock);
+    for(int i=0;i<pool.workerCount;i++) pthread_join(pool.threads[i], NULL);
+    pool.workerCount = 0;
+    pthread_cond_destroy(&pool.wake);
+    pthread_cond_destroy(&pool.done);
+    pthread_mutex_destroy(&pool.lock);
+}
+
+void ArenasAdvance(Arena *arenas, int count, double now){
+    if(pool.workerCount == 0 || count < 2){
+        for(int i=0;i<count;i++) Advance(&arenas[i], now);
+        return;
+    }
+    pthread_mutex_lock(&pool.lock);
+    pool.arenas = arenas;
+    pool.count = count;
+    pool.now = now;
+    atomic_store(&pool.next, 0);
+    pool.busy = pool.workerCount;
+    pool.generation++;
+    pthread_cond_broadcast(&pool.wake);
+    pthread_mutex_unlock(&pool.lock);
+
+    RunTasks();
+    pthread_mutex_lock(&pool.lock);
+    while(pool.busy > 0) pthread_cond_wait(&pool.done, &pool.lock);
+    pthread_mutex_unlock(&pool.lock);
+}
+#else
+void ArenaPoolStart(int workers){ (void)workers; }
+void ArenaPoolStop(void){}
+
+void ArenasAdvance(Arena *arenas, int count, double now){
+    for(int i=0;i<count;i++) Advance(&arenas[i], now);
+}
+#endif
+
+int ArenaCoreCount(void){
+#if defined(_WIN32)
+    const char *env = getenv("NUMBER_OF_PROCESSORS");
+    int n = env ? atoi(env) : 0;
+#elif defined(PLATFORM_WEB)
+    int n = 1;
+#else
+    int n = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return n > 0 ? n : 1;
+}
@@ -0,0 +1,51 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+// Tournament play: several independent matches in one process, one Arena each.
+// An arena holds only per-match state (the simulation, its clock, hits waiting
+// for their tick, the events it raised); the board, rules and every loaded
+// asset are shared, so an extra arena costs about 5 KB plus mole arrays sized
+// to the board.
+// ArenasAdvance() steps all arenas on a small worker pool. Sounds and effects
+// aren't thread-safe, so a stepping arena queues its sim events and the caller
+// plays them afterwards on its own thread.
+//
+// No raylib here; the caller supplies the clock.
+
+#include "sim.h"
+
+#define ARENA_MAX 8             // at least one team each
+#define ARENA_MAX_HITS 64       // struck since the last frame
+#define ARENA_MAX_EVENTS 128    // raised in one frame
+
+typedef struct {
+    double time;
+    uint16_t hole;
+    uint8_t team;
+} ArenaHit;
+
+typedef struct {
+    Match match;
+    double simClock;            // time at which match.tick ended
+    ArenaHit hits[ARENA_MAX_HITS];
+    int hitCount;
+    SimEvent events[ARENA_MAX_EVENTS];
+    int eventCount;
+    unsigned eventsDropped;     // queue full; only effects and telemetry miss them
+    int firstTeam;              // bindings team playing as the match's team 0
+    uint32_t serial;            // telemetry match number
+} Arena;
+
+// Pool of up to workers threads besides the caller's; 0 steps everything on the caller
+void ArenaPoolStart(int workers);
+void ArenaPoolStop(void);
+int ArenaCoreCount(void);
+
+// A SimEventFn (eventUser = the arena): keeps the event until the caller drains events[]
+void ArenaQueueEvent(void *arena, const SimEvent *event);
+// Applied in the tick it was struck in; dropped once the match is over
+void ArenaHitAt(Arena *arena, double time, int hole, int team);
+// Steps every arena's match up to now, in parallel
+void ArenasAdvance(Arena *arenas, int count, double now);
+
+#endif
@@ -0,0 +1,135 @@
+#include "atlas.h"
+
+const char *const spritePaths[SPRITE_COUNT] = {
+    "assets/visual/mole_normal.png", "assets/visual/mole_normal_hit.png",
+    "assets/visual/mole_golden.png", "assets/visual/mole_golden_hit.png",
+    "assets/visual/mole_bomber.png", "assets/visual/mole_bomber_hit.png",
+    "assets/visual/hammer_red.png", "assets/visual/hammer_red_hit.png",
+    "assets/visual/hammer_blue.png", "assets/visual/hammer_blue_hit.png",
+    "assets/visual/star.png",
+    "assets/visual/red_box.png", "assets/visual/blue_box.png",
+    "assets/visual/black_box.png", "assets/visual/green_box.png"
+};
+
+RenderStats renderStats;
+static unsigned int lastTextureId = 0;
+
+// ------------------- Packing -------------------
+// Tallest first, left to right on shelves; a sprite that doesn't fit opens a new page
+bool AtlasPackImages(AtlasImage *out, const Image images[SPRITE_COUNT], unsigned mask){
+    int order[SPRITE_COUNT], count = 0;
+    for(int i=0;i<SPRITE_COUNT;i++) if(mask & SPRITE_BIT(i)) order[count++] = i;
+    for(int i=1;i<count;i++){
+        int id = order[i], j = i;
+        while(j > 0 && images[order[j-1]].height < images[id].height){ order[j] = order[j-1]; j--; }
+        order[j] = id;
+    }
+
+    *out = (AtlasImage){ .mask = mask };
+    int page = -1, x = 0, y = 0, shelfHeight = 0;
+    for(int n=0;n<count;n++){
+        int id = order[n];
+        int w = images[id].width + ATLAS_PADDING, h = images[id].height + ATLAS_PADDING;
+        if(w > ATLAS_PAGE_SIZE || h > ATLAS_PAGE_SIZE) return false;
+
+        if(page >= 0 && x + w > ATLAS_PAGE_SIZE){ x = 0; y += shelfHeight; shelfHeight = 0; }
+        if(page < 0 || y + h > ATLAS_PAGE_SIZE){
+            if(++page >= ATLAS_MAX_PAGES) return false;
+            out->pages[page] = GenImageColor(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, BLANK);
+            out->pageCount = page + 1;
+            x = y = shelfHeight = 0;
+        }
+
+        Rectangle src = { 0, 0, images[id].width, images[id].height };
+        Rectangle dst = { x, y, images[id].width, images[id].height };
+        ImageDraw(&out->pages[page], images[id], src, dst, WHITE);
+        out->sprites[id] = (SpriteRect){ page, dst };
+
+        x += w;
+        if(h > shelfHeight) shelfHeight = h;
+    }
+    return true;
+}
+
+bool AtlasBuildImage(AtlasImage *out, unsigned mask){
+    Image images[SPRITE_COUNT] = {0};
+    for(int i=0;i<SPRITE_COUNT;i++) if(mask & SPRITE_BIT(i)) images[i] = LoadImage(spritePaths[i]);
+    bool ok = AtlasPackImages(out, images, mask);
+    for(int i=0;i<SPRITE_COUNT;i++) UnloadImage(images[i]);
+    if(!ok) TraceLog(LOG_WARNING, "ATLAS: sprites do not fit in %d pages", ATLAS_MAX_PAGES);
+    return ok;
+}
+
+void AtlasAppend(Atlas *atlas, const AtlasImage *image){
+    int first = atlas->pageCount, count = 0;
+    if(first + image->pageCount > ATLAS_MAX_PAGES){
+        TraceLog(LOG_WARNING, "ATLAS: no room for %d more page(s)", image->pageCount);
+        return;
+    }
+    for(int i=0;i<image->pageCount;i++) atlas->pages[first + i] = LoadTextureFromImage(image->pages[i]);
+    atlas->pageCount += image->pageCount;
+    for(int i=0;i<SPRITE_COUNT;i++){
+        if(!(image->mask & SPRITE_BIT(i))) continue;
+        atlas->sprites[i] = (SpriteRect){ first + image->sprites[i].page, image->sprites[i].rect };
+        count++;
+    }
+    TraceLog(LOG_INFO, "ATLAS: %d sprites packed into %d page(s)", count, image->pageCount);
+}
+
+void UnloadAtlasImage(AtlasImage *image){
+    for(int i=0;i<image->pageCount;i++) UnloadImage(image->pages[i]);
+    image->pageCount = 0;
+}
+
+void UnloadAtlas(Atlas *atlas){
+    for(int i=0;i<atlas->pageCount;i++) UnloadTexture(atlas->pages[i]);
+    atlas->pageCount = 0;
+}
+
+// ------------------- Drawing -------------------
+Vector2 SpriteSize(const Atlas *atlas, SpriteId id){
+    return (Vector2){ atlas->sprites[id].rect.width, atlas->sprites[id].rect.height };
+}
+
+void DrawSprite(const Atlas *atlas, SpriteId id, float x, float y, Color tint){
+    const SpriteRect *s = &atlas->sprites[id];
+    Texture2D page = atlas->pages[s->page];
+    RenderStatsTrack(page.id);
+    DrawTextureRec(page, s->rect, (Vector2){ (int)x, (int)y }, tint);
+}
+
+void DrawSpriteRect(const Atlas *atlas, SpriteId id, Rectangle dest, Color tint){
+    const SpriteRect *s = &atlas->sprites[id];
+    Texture2D page = atlas->pages[s->page];
+    RenderStatsTrack(page.id);
+    DrawTexturePro(page, s->rect, dest, (Vector2){0, 0}, 0.0f, tint);
+}
+
+void DrawTextureCounted(Texture2D texture, int x, int y, Color tint){
+    RenderStatsTrack(texture.id);
+    DrawTexture(texture, x, y, tint);
+}
+
+void DrawTextureRectCounted(Texture2D texture, Rectangle dest, Color tint){
+    RenderStatsTrack(texture.id);
+    DrawTexturePro(texture, (Rectangle){ 0, 0, texture.width, texture.height }, dest, (Vector2){0, 0}, 0.0f, tint);
+}
+
+void DrawTextCounted(Font font, const char *text, Vector2 pos, float size, float spacing, Color tint){
+    RenderStatsTrack(font.texture.id);
+    DrawTextEx(font, text, pos, size, spacing, tint);
+}
+
+// ------------------- Counters -------------------
+void RenderStatsBeginFrame(void){
+    renderStats = (RenderStats){0};
+    lastTextureId = 0;
+}
+
+void RenderStatsTrack(unsigned int textureId){
+    renderStats.drawCalls++;
+    if(textureId != lastTextureId){
+        renderStats.textureSwitches++;
+        lastTextureId = textureId;
+    }
+}
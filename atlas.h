@@ -0,0 +1,78 @@
+#ifndef ATLAS_H
+#define ATLAS_H
+
+// Sprite atlas: packs the small sprites into one or a few texture pages so a frame's
+// sprites share a texture and raylib can batch them instead of flushing per draw.
+
+#include "raylib.h"
+
+#define ATLAS_PAGE_SIZE 1024
+#define ATLAS_MAX_PAGES 4
+#define ATLAS_PADDING 2
+
+typedef enum {
+    SPRITE_MOLE_NORMAL, SPRITE_MOLE_NORMAL_HIT,
+    SPRITE_MOLE_GOLDEN, SPRITE_MOLE_GOLDEN_HIT,
+    SPRITE_MOLE_BOMBER, SPRITE_MOLE_BOMBER_HIT,
+    SPRITE_HAMMER_RED, SPRITE_HAMMER_RED_HIT,
+    SPRITE_HAMMER_BLUE, SPRITE_HAMMER_BLUE_HIT,
+    SPRITE_STAR,
+    SPRITE_BOX_RED, SPRITE_BOX_BLUE, SPRITE_BOX_BLACK, SPRITE_BOX_GREEN,
+    SPRITE_COUNT
+} SpriteId;
+
+// Sets of sprites, for building the atlas in stages
+#define SPRITE_BIT(id) (1u << (id))
+#define SPRITE_MASK_ALL (SPRITE_BIT(SPRITE_COUNT) - 1)
+#define SPRITE_MASK_BOXES (SPRITE_BIT(SPRITE_BOX_RED) | SPRITE_BIT(SPRITE_BOX_BLUE) | SPRITE_BIT(SPRITE_BOX_BLACK) | SPRITE_BIT(SPRITE_BOX_GREEN))
+
+typedef struct {
+    int page;
+    Rectangle rect;     // pixels within the page
+} SpriteRect;
+
+// CPU side, built before any GPU upload
+typedef struct {
+    Image pages[ATLAS_MAX_PAGES];
+    int pageCount;
+    SpriteRect sprites[SPRITE_COUNT];
+    unsigned mask;      // sprites it holds
+} AtlasImage;
+
+typedef struct {
+    Texture2D pages[ATLAS_MAX_PAGES];
+    int pageCount;
+    SpriteRect sprites[SPRITE_COUNT];
+} Atlas;
+
+// Per-frame draw counters, reset with RenderStatsBeginFrame()
+typedef struct {
+    int drawCalls;          // sprite/text/texture draws submitted
+    int textureSwitches;    // texture changes between draws, each one flushes raylib's batch
+} RenderStats;
+
+extern const char *const spritePaths[SPRITE_COUNT];
+extern RenderStats renderStats;
+
+// Shelf-pack the sprites in mask into pages (images are not unloaded)
+bool AtlasPackImages(AtlasImage *out, const Image images[SPRITE_COUNT], unsigned mask);
+// Loads the files in spritePaths for the sprites in mask and packs them
+bool AtlasBuildImage(AtlasImage *out, unsigned mask);
+// Uploads the pages after any already in atlas, so an atlas can arrive in parts
+void AtlasAppend(Atlas *atlas, const AtlasImage *image);
+void UnloadAtlasImage(AtlasImage *image);
+void UnloadAtlas(Atlas *atlas);
+
+Vector2 SpriteSize(const Atlas *atlas, SpriteId id);
+void DrawSprite(const Atlas *atlas, SpriteId id, float x, float y, Color tint);
+void DrawSpriteRect(const Atlas *atlas, SpriteId id, Rectangle dest, Color tint);   // scaled to dest
+
+// Counted wrappers for draws that don't go through the atlas
+void DrawTextureCounted(Texture2D texture, int x, int y, Color tint);
+void DrawTextureRectCounted(Texture2D texture, Rectangle dest, Color tint);    // whole texture scaled to dest
+void DrawTextCounted(Font font, const char *text, Vector2 pos, float size, float spacing, Color tint);
+
+void RenderStatsBeginFrame(void);
+void RenderStatsTrack(unsigned int textureId);
+
+#endif
@@ -0,0 +1,280 @@
+#if !defined(_WIN32)
+    #define _POSIX_C_SOURCE 200112L     // nanosleep under -std=c11
+#endif
+#include "audio.h"
+#include "profiler.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(PLATFORM_WEB)
+    #define AUDIO_THREADS 0     // no shared-memory threads in the default web build
+#else
+    #define AUDIO_THREADS 1
+    #include <pthread.h>
+#endif
+
+#if defined(_WIN32)
+    void __stdcall Sleep(unsigned long ms);
+#endif
+
+AudioStats audioStats;
+
+// ------------------- Voice Pools -------------------
+static SoundPool *pools[AUDIO_MAX_POOLS];
+static int poolCount;
+
+// Sounds arrive from the loader, so voices are made on first use
+static bool PoolReady(SoundPool *pool){
+    if(pool->voiceCount) return true;
+    if(!pool->source || pool->source->frameCount == 0) return false;
+    int size = pool->size < 1 ? 1 : pool->size > AUDIO_MAX_VOICES ? AUDIO_MAX_VOICES : pool->size;
+    pool->voices[0] = *pool->source;
+    for(int i=1;i<size;i++) pool->voices[i] = LoadSoundAlias(*pool->source);
+    pool->voiceCount = size;
+    if(poolCount < AUDIO_MAX_POOLS) pools[poolCount++] = pool;
+    return true;
+}
+
+static int OldestVoice(const SoundPool *pool){
+    int oldest = 0;
+    for(int i=1;i<pool->voiceCount;i++) if(pool->startedAt[i] < pool->startedAt[oldest]) oldest = i;
+    return oldest;
+}
+
+void PlayPooled(SoundPool *pool){
+    if(!PoolReady(pool)) return;
+
+    int voice = -1, active = 0;
+    for(int p=0;p<poolCount;p++){
+        for(int i=0;i<pools[p]->voiceCount;i++){
+            if(!IsSoundPlaying(pools[p]->voices[i])){
+                if(pools[p] == pool && voice < 0) voice = i;
+            }else active++;
+        }
+    }
+
+    if(voice < 0){
+        // Pool busy: cut its oldest voice
+        voice = OldestVoice(pool);
+        StopSound(pool->voices[voice]);
+        audioStats.stolen++;
+    }else if(active >= AUDIO_MAX_ACTIVE){
+        // Mixer budget spent: lowest priority first, then oldest
+        SoundPool *victim = NULL;
+        int victimVoice = -1;
+        for(int p=0;p<poolCount;p++){
+            SoundPool *other = pools[p];
+            if(other->priority > pool->priority) continue;
+            for(int i=0;i<other->voiceCount;i++){
+                if(!IsSoundPlaying(other->voices[i])) continue;
+                if(!victim || other->priority < victim->priority
+                   || (other->priority == victim->priority && other->startedAt[i] < victim->startedAt[victimVoice])){
+                    victim = other;
+                    victimVoice = i;
+                }
+            }
+        }
+        if(!victim){
+            audioStats.dropped++;
+            return;
+        }
+        StopSound(victim->voices[victimVoice]);
+        audioStats.stolen++;
+    }
+
+    pool->startedAt[voice] = GetTime();
+    PlaySoundCounted(pool->voices[voice]);
+    audioStats.played++;
+}
+
+void SoundPoolUnload(SoundPool *pool){
+    for(int i=1;i<pool->voiceCount;i++) UnloadSoundAlias(pool->voices[i]);
+    for(int p=0;p<poolCount;p++){
+        if(pools[p] == pool){ pools[p] = pools[--poolCount]; break; }
+    }
+    pool->voiceCount = 0;
+}
+
+// ------------------- Music -------------------
+#if AUDIO_THREADS
+#define MUSIC_RING_SAMPLES 32768    // power of two; 0.74 s of mono 44.1 kHz
+
+// Single producer (music thread), single consumer (the mixer's stream callback).
+// Positions are free-running sample counts; each side only writes its own.
+static struct {
+    int16_t ring[MUSIC_RING_SAMPLES];
+    atomic_size_t writePos, readPos;
+    atomic_bool running, decoded;
+    atomic_uint underruns;
+
+    pthread_t thread;
+    bool started, streaming;
+    char ext[16];
+    unsigned char *data;
+    int size;
+    bool ownsData;
+    Wave wave;              // written by the thread before `decoded`
+    AudioStream stream;
+    float volume;
+} music;
+
+static void SleepMs(int ms){
+#if defined(_WIN32)
+    Sleep((unsigned long)ms);
+#else
+    struct timespec ts = { 0, ms*1000000L };
+    nanosleep(&ts, NULL);
+#endif
+}
+
+// Mixer thread: copy out what's queued, silence for the rest
+static void MusicCallback(void *buffer, unsigned int frames){
+    int16_t *out = buffer;
+    size_t want = (size_t)frames*music.wave.channels;
+    size_t r = atomic_load_explicit(&music.readPos, memory_order_relaxed);
+    size_t w = atomic_load_explicit(&music.writePos, memory_order_acquire);
+    size_t n = (w - r < want) ? w - r : want;
+    for(size_t done=0;done<n;){
+        size_t at = (r + done) & (MUSIC_RING_SAMPLES - 1);
+        size_t chunk = (MUSIC_RING_SAMPLES - at < n - done) ? MUSIC_RING_SAMPLES - at : n - done;
+        memcpy(out + done, music.ring + at, chunk*sizeof(int16_t));
+        done += chunk;
+    }
+    atomic_store_explicit(&music.readPos, r + n, memory_order_release);
+    if(n < want){
+        memset(out + n, 0, (want - n)*sizeof(int16_t));
+        atomic_fetch_add(&music.underruns, 1);
+    }
+}
+
+// raylib has no incremental OGG decoder in its API, so the thread decodes the
+// track once (31 s mono, under 3 MB as 16-bit) and then keeps the ring topped
+// up, looping
+static void *MusicThread(void *arg){
+    (void)arg;
+    Wave wave = LoadWaveFromMemory(music.ext, music.data, music.size);
+    if(music.ownsData) UnloadFileData(music.data);
+    music.data = NULL;
+    if(wave.frameCount > 0 && wave.sampleSize != 16) WaveFormat(&wave, wave.sampleRate, 16, wave.channels);
+    music.wave = wave;
+    atomic_store_explicit(&music.decoded, true, memory_order_release);
+    if(wave.frameCount == 0) return NULL;
+
+    const int16_t *pcm = wave.data;
+    size_t total = (size_t)wave.frameCount*wave.channels, cursor = 0;
+    while(atomic_load(&music.running)){
+        size_t w = atomic_load_explicit(&music.writePos, memory_order_relaxed);
+        size_t r = atomic_load_explicit(&music.readPos, memory_order_acquire);
+        size_t space = MUSIC_RING_SAMPLES - (w - r);
+        if(space < MUSIC_RING_SAMPLES/4){ SleepMs(5); continue; }
+        while(space > 0){
+            size_t at = w & (MUSIC_RING_SAMPLES - 1);
+            size_t n = space;
+            if(n > MUSIC_RING_SAMPLES - at) n = MUSIC_RING_SAMPLES - at;
+            if(n > total - cursor) n = total - cursor;
+            memcpy(music.ring + at, pcm + cursor, n*sizeof(int16_t));
+            w += n;
+            space -= n;
+            cursor = (cursor + n == total) ? 0 : cursor + n;
+        }
+        atomic_store_explicit(&music.writePos, w, memory_order_release);
+    }
+    return NULL;
+}
+
+bool MusicStart(const char *path, const Pack *pack, float volume){
+    const PackEntry *e = pack ? PackFind(pack, path) : NULL;
+    if(e && e->kind == PACK_STREAM){
+        music.data = (unsigned char *)PackData(pack, e);     // the pack stays mapped for the whole run
+        music.size = (int)e->size;
+        music.ownsData = false;
+    }else{
+        music.data = LoadFileData(path, &music.size);
+        music.ownsData = true;
+    }
+    if(!music.data) return false;
+
+    snprintf(music.ext, sizeof(music.ext), "%s", GetFileExtension(path));
+    music.volume = volume;
+    atomic_store(&music.writePos, 0);
+    atomic_store(&music.readPos, 0);
+    atomic_store(&music.decoded, false);
+    atomic_store(&music.running, true);
+    if(pthread_create(&music.thread, NULL, MusicThread, NULL) != 0){
+        if(music.ownsData) UnloadFileData(music.data);
+        music.data = NULL;
+        TraceLog(LOG_WARNING, "AUDIO: cannot start the music thread");
+        return false;
+    }
+    music.started = true;
+    return true;
+}
+
+// The only main-thread work: creating the stream once the track is decoded
+void MusicUpdate(void){
+    if(!music.started || music.streaming || !atomic_load_explicit(&music.decoded, memory_order_acquire)) return;
+    if(music.wave.frameCount == 0){
+        TraceLog(LOG_WARNING, "AUDIO: cannot decode the music");
+        MusicStop();
+        return;
+    }
+    music.stream = LoadAudioStream(music.wave.sampleRate, 16, music.wave.channels);
+    SetAudioStreamCallback(music.stream, MusicCallback);
+    SetAudioStreamVolume(music.stream, music.volume);
+    PlayAudioStream(music.stream);
+    music.streaming = true;
+    atomic_store(&music.underruns, 0);
+    TraceLog(LOG_INFO, "AUDIO: music decoded off-thread, %u frames, streaming", music.wave.frameCount);
+}
+
+void MusicStop(void){
+    if(!music.started) return;
+    if(music.streaming) UnloadAudioStream(music.stream);    // no more callbacks after this
+    atomic_store(&music.running, false);
+    pthread_join(music.thread, NULL);
+    if(music.wave.data) UnloadWave(music.wave);
+    music.wave = (Wave){0};
+    music.started = music.streaming = false;
+}
+
+bool MusicNeedsUpdates(void){
+    return music.started && !music.streaming;
+}
+
+unsigned MusicUnderruns(void){
+    return atomic_load(&music.underruns);
+}
+#else
+static Music fallback;
+static bool fallbackLoaded;
+
+bool MusicStart(const char *path, const Pack *pack, float volume){
+    const PackEntry *e = pack ? PackFind(pack, path) : NULL;
+    if(e && e->kind == PACK_STREAM) fallback = LoadMusicStreamFromMemory(GetFileExtension(path), PackData(pack, e), (int)e->size);
+    else fallback = LoadMusicStream(path);
+    fallbackLoaded = fallback.frameCount > 0;
+    if(!fallbackLoaded) return false;
+    SetMusicVolume(fallback, volume);
+    PlayMusicStream(fallback);
+    return true;
+}
+
+void MusicUpdate(void){
+    if(fallbackLoaded) UpdateMusicStream(fallback);
+}
+
+bool MusicNeedsUpdates(void){
+    return fallbackLoaded;     // raylib's Music is refilled from the main loop
+}
+
+void MusicStop(void){
+    if(fallbackLoaded) UnloadMusicStream(fallback);
+    fallbackLoaded = false;
+}
+
+unsigned MusicUnderruns(void){
+    return 0;
+}
+#endif
@@ -0,0 +1,51 @@
+#ifndef AUDIO_H
+#define AUDIO_H
+
+// Sound effects and music.
+//
+// Each effect plays through a small pool of voices (LoadSoundAlias() copies that
+// share the sample data), so two hits in one frame both sound instead of the
+// second restarting the first. When a pool is busy its oldest voice is reused;
+// when AUDIO_MAX_ACTIVE voices are already mixing, a new sound takes over the
+// oldest voice of the lowest priority at or below its own, or is dropped.
+//
+// Music is decoded on its own thread and streamed through a lock-free ring to
+// an AudioStream callback, so the main loop never decodes audio. Builds without
+// threads (the default web build) fall back to raylib's Music streaming.
+
+#include "raylib.h"
+#include "pack.h"
+
+#define AUDIO_MAX_VOICES 8      // per pool
+#define AUDIO_MAX_ACTIVE 16     // mixed at once, across all pools
+#define AUDIO_MAX_POOLS 16
+
+// ------------------- Voice Pools -------------------
+typedef struct {
+    const Sound *source;    // loaded elsewhere; the voices are made on first play
+    int size;               // voices, up to AUDIO_MAX_VOICES
+    int priority;           // higher takes voices from lower
+    Sound voices[AUDIO_MAX_VOICES];
+    double startedAt[AUDIO_MAX_VOICES];
+    int voiceCount;
+} SoundPool;
+
+typedef struct {
+    unsigned played;
+    unsigned stolen;        // a playing voice was cut short for a new sound
+    unsigned dropped;       // no voice could be had at this priority
+} AudioStats;
+
+extern AudioStats audioStats;
+
+void PlayPooled(SoundPool *pool);
+void SoundPoolUnload(SoundPool *pool);  // the aliases; the source Sound stays with its owner
+
+// ------------------- Music -------------------
+bool MusicStart(const char *path, const Pack *pack, float volume);   // pack may be NULL: loose file
+void MusicUpdate(void);         // once a frame; hooks up the stream when decoding is done
+bool MusicNeedsUpdates(void);   // false once MusicUpdate has nothing left to do (the main loop may block)
+void MusicStop(void);
+unsigned MusicUnderruns(void);  // callbacks the ring couldn't fill
+
+#endif
@@ -0,0 +1,193 @@
+#include "board.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ------------------- Built-in Board -------------------
+// Side buttons of the original board, by hole (not in hole order on screen)
+static const SimVec2 defaultRedButtons[5] = { {50, 330}, {50, 480}, {50, 180}, {50, 630}, {50, 780} };
+static const SimVec2 defaultBlueButtons[5] = { {1750, 630}, {1750, 480}, {1750, 780}, {1750, 330}, {1750, 180} };
+
+void BoardDefault(BoardLayout *layout){
+    memset(layout, 0, sizeof(*layout));
+    layout->holes = simDefaultBoard;
+    for(int i=0;i<simDefaultBoard.holeCount;i++){
+        layout->redButtons[i] = (BoardRect){ defaultRedButtons[i].x, defaultRedButtons[i].y, 120, 120 };
+        layout->blueButtons[i] = (BoardRect){ defaultBlueButtons[i].x, defaultBlueButtons[i].y, 120, 120 };
+    }
+}
+
+static void PlaceButtons(BoardLayout *layout, int i, float size){
+    SimVec2 p = layout->holes.pos[i];
+    layout->redButtons[i] = (BoardRect){ p.x - 60 - size, p.y - size/2, size, size };
+    layout->blueButtons[i] = (BoardRect){ p.x + 60, p.y - size/2, size, size };
+}
+
+// ------------------- Layout Files -------------------
+bool BoardLoad(BoardLayout *layout, const char *path){
+    FILE *f = fopen(path, "r");
+    if(!f){
+        fprintf(stderr, "BOARD: cannot open %s\n", path);
+        return false;
+    }
+    memset(layout, 0, sizeof(*layout));
+    layout->holes.spawnMeanIdle = simDefaultBoard.spawnMeanIdle;
+    layout->custom = true;
+
+    float buttonSize = 120;
+    char line[256];
+    int lineNo = 0;
+    bool ok = true;
+    while(ok && fgets(line, sizeof(line), f)){
+        lineNo++;
+        char *p = line;
+        while(*p == ' ' || *p == '\t') p++;
+        if(*p == '#' || *p == '\n' || *p == '\r' || *p == 0) continue;
+
+        float v[6];
+        int n;
+        if(sscanf(p, "idle %f", &v[0]) == 1 && v[0] > 0) layout->holes.spawnMeanIdle = v[0];
+        else if(sscanf(p, "button %f", &v[0]) == 1 && v[0] > 0) buttonSize = v[0];
+        else if((n = sscanf(p, "hole %f %f %f %f %f %f", &v[0], &v[1], &v[2], &v[3], &v[4], &v[5])) == 2 || n == 6){
+            int i = layout->holes.holeCount;
+            if(i == SIM_MAX_HOLES){
+                fprintf(stderr, "BOARD: %s has more than %d holes\n", path, SIM_MAX_HOLES);
+                ok = false;
+                break;
+            }
+            layout->holes.pos[i] = (SimVec2){ v[0], v[1] };
+            if(n == 6){
+                layout->redButtons[i] = (BoardRect){ v[2], v[3], buttonSize, buttonSize };
+                layout->blueButtons[i] = (BoardRect){ v[4], v[5], buttonSize, buttonSize };
+            }else PlaceButtons(layout, i, buttonSize);
+            layout->holes.holeCount++;
+        }else{
+            fprintf(stderr, "BOARD: %s:%d: cannot parse '%s'\n", path, lineNo, strtok(p, "\r\n"));
+            ok = false;
+        }
+    }
+    fclose(f);
+
+    if(ok && layout->holes.holeCount == 0){
+        fprintf(stderr, "BOARD: %s has no holes\n", path);
+        ok = false;
+    }
+    return ok;
+}
+
+void BoardFromHoles(BoardLayout *layout, const SimBoard *holes){
+    BoardDefault(layout);
+    if(holes->holeCount == simDefaultBoard.holeCount
+       && !memcmp(holes->pos, simDefaultBoard.pos, (size_t)holes->holeCount*sizeof(SimVec2))){
+        layout->holes.spawnMeanIdle = holes->spawnMeanIdle;
+        return;
+    }
+    memset(layout, 0, sizeof(*layout));
+    layout->holes = *holes;
+    layout->custom = true;
+    for(int i=0;i<holes->holeCount;i++) PlaceButtons(layout, i, 120);
+}
+
+void BoardGenerate(BoardLayout *layout, int holeCount, float width, float height){
+    if(holeCount > SIM_MAX_HOLES) holeCount = SIM_MAX_HOLES;
+    memset(layout, 0, sizeof(*layout));
+    layout->holes.holeCount = holeCount;
+    layout->holes.spawnMeanIdle = simDefaultBoard.spawnMeanIdle;
+    layout->custom = true;
+
+    int cols = (int)ceilf(sqrtf(holeCount*width/height));
+    int rows = (holeCount + cols - 1)/cols;
+    float cw = width/cols, ch = height/rows;
+    for(int i=0;i<holeCount;i++){
+        layout->holes.pos[i] = (SimVec2){ (i%cols + 0.5f)*cw, (i/cols + 0.5f)*ch };
+        float size = cw*0.2f;
+        SimVec2 p = layout->holes.pos[i];
+        layout->redButtons[i] = (BoardRect){ p.x - cw*0.45f, p.y - size/2, size, size };
+        layout->blueButtons[i] = (BoardRect){ p.x + cw*0.25f, p.y - size/2, size, size };
+    }
+}
+
+// ------------------- Hit Grid -------------------
+static const BoardRect *ButtonRect(const BoardLayout *layout, int id){
+    return (id & 1) ? &layout->blueButtons[id >> 1] : &layout->redButtons[id >> 1];
+}
+
+// Cells a rect overlaps, clamped to the grid
+static void CellSpan(const HitGrid *grid, const BoardRect *r, int *x0, int *y0, int *x1, int *y1){
+    *x0 = (int)floorf(r->x/grid->cellSize);
+    *y0 = (int)floorf(r->y/grid->cellSize);
+    *x1 = (int)floorf((r->x + r->width)/grid->cellSize);
+    *y1 = (int)floorf((r->y + r->height)/grid->cellSize);
+    if(*x0 < 0) *x0 = 0;
+    if(*y0 < 0) *y0 = 0;
+    if(*x1 >= grid->cols) *x1 = grid->cols - 1;
+    if(*y1 >= grid->rows) *y1 = grid->rows - 1;
+}
+
+bool HitGridBuild(HitGrid *grid, const BoardLayout *layout, float cellSize){
+    memset(grid, 0, sizeof(*grid));
+    grid->layout = layout;
+    grid->cellSize = cellSize;
+
+    int buttons = layout->holes.holeCount*2;
+    float maxX = 0, maxY = 0;
+    for(int id=0;id<buttons;id++){
+        const BoardRect *r = ButtonRect(layout, id);
+        if(r->x + r->width > maxX) maxX = r->x + r->width;
+        if(r->y + r->height > maxY) maxY = r->y + r->height;
+    }
+    grid->cols = (int)(maxX/cellSize) + 1;
+    grid->rows = (int)(maxY/cellSize) + 1;
+
+    int cells = grid->cols*grid->rows;
+    grid->cellStart = calloc((size_t)cells + 1, sizeof(int));
+    if(!grid->cellStart) return false;
+
+    // Count, prefix-sum, fill: each cell's buttons end up contiguous and in id order
+    int x0, y0, x1, y1;
+    for(int id=0;id<buttons;id++){
+        CellSpan(grid, ButtonRect(layout, id), &x0, &y0, &x1, &y1);
+        for(int y=y0;y<=y1;y++) for(int x=x0;x<=x1;x++) grid->cellStart[y*grid->cols + x + 1]++;
+    }
+    for(int c=0;c<cells;c++) grid->cellStart[c + 1] += grid->cellStart[c];
+
+    grid->items = malloc(((size_t)grid->cellStart[cells] + 1)*sizeof(int));
+    int *fill = malloc((size_t)cells*sizeof(int));
+    if(!grid->items || !fill){
+        free(fill);
+        HitGridFree(grid);
+        return false;
+    }
+    memcpy(fill, grid->cellStart, (size_t)cells*sizeof(int));
+    for(int id=0;id<buttons;id++){
+        CellSpan(grid, ButtonRect(layout, id), &x0, &y0, &x1, &y1);
+        for(int y=y0;y<=y1;y++) for(int x=x0;x<=x1;x++) grid->items[fill[y*grid->cols + x]++] = id;
+    }
+    free(fill);
+    return true;
+}
+
+int HitGridQuery(const HitGrid *grid, float x, float y, int *team){
+    if(!grid->cellStart || x < 0 || y < 0) return -1;
+    int cx = (int)(x/grid->cellSize), cy = (int)(y/grid->cellSize);
+    if(cx >= grid->cols || cy >= grid->rows) return -1;
+
+    int c = cy*grid->cols + cx;
+    for(int k=grid->cellStart[c];k<grid->cellStart[c + 1];k++){
+        int id = grid->items[k];
+        const BoardRect *r = ButtonRect(grid->layout, id);
+        if(x >= r->x && x <= r->x + r->width && y >= r->y && y <= r->y + r->height){   // edges inclusive, as CheckCollisionPointRec
+            *team = id & 1;
+            return id >> 1;
+        }
+    }
+    return -1;
+}
+
+void HitGridFree(HitGrid *grid){
+    free(grid->cellStart);
+    free(grid->items);
+    grid->cellStart = NULL;
+    grid->items = NULL;
+}
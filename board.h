@@ -0,0 +1,48 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+// Board layouts: hole positions plus each hole's red/blue touch buttons. Either
+// the built-in 5-hole board or a layout file read at runtime:
+//
+//   # comments and blank lines are ignored
+//   idle 40.0                       mean seconds a hole stays empty (default 3.3)
+//   button 64                       button size for holes that don't place their own (default 120)
+//   hole 707 510                    buttons go left (red) and right (blue) of the hole
+//   hole 376 640  50 180  1750 780  or: hole x y  redX redY  blueX blueY
+//
+// The hit grid buckets buttons into uniform cells so a click tests a handful of
+// buttons instead of every one on the board. No raylib dependency.
+
+#include "sim.h"
+
+typedef struct { float x, y, width, height; } BoardRect;
+
+typedef struct {
+    SimBoard holes;
+    BoardRect redButtons[SIM_MAX_HOLES];
+    BoardRect blueButtons[SIM_MAX_HOLES];
+    bool custom;    // holes aren't painted on the game background
+} BoardLayout;
+
+void BoardDefault(BoardLayout *layout);
+bool BoardLoad(BoardLayout *layout, const char *path);
+// Layout for holes that came without buttons (replays): the built-in board if
+// they match it, otherwise buttons beside each hole
+void BoardFromHoles(BoardLayout *layout, const SimBoard *holes);
+// Evenly spread rows of holes with small flanking buttons (stress tests, benchmarks)
+void BoardGenerate(BoardLayout *layout, int holeCount, float width, float height);
+
+// ------------------- Hit Grid -------------------
+typedef struct {
+    const BoardLayout *layout;
+    float cellSize;
+    int cols, rows;
+    int *cellStart;     // cols*rows + 1 offsets into items
+    int *items;         // button ids: hole*2 for red, hole*2 + 1 for blue
+} HitGrid;
+
+bool HitGridBuild(HitGrid *grid, const BoardLayout *layout, float cellSize);
+int HitGridQuery(const HitGrid *grid, float x, float y, int *team);   // hole under the point, or -1; team 0 red, 1 blue
+void HitGridFree(HitGrid *grid);
+
+#endif
@@ -0,0 +1,1099 @@
+#include "game.h"
+#include "atlas.h"
+#include "textcache.h"
+#include "loader.h"
+#include "input.h"
+#include "profiler.h"
+#include "board.h"
+#include "net.h"
+#include "replay.h"
+#include "audio.h"
+#include "render.h"
+#include "particles.h"
+#include "telemetry.h"
+#include "history.h"
+#include "arena.h"
+#if defined(PLATFORM_WEB)
+    #include <emscripten.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// ------------------- Virtual Buttons -------------------
+typedef struct { Rectangle rect; } VirtualButton;
+
+// ------------------- Globals -------------------
+GameState currentState = STATE_MENU;
+
+// Backgrounds
+Texture2D backgroundMenu;
+Texture2D backgroundGame;
+
+// Match state (moles, hammers, scores, timer) lives in the simulation core, one
+// match per arena. Local, online and replay play arena 0; a tournament
+// (--arenas N) runs all of them side by side on the shared assets.
+Arena arenas[ARENA_MAX];
+int arenaCount = 1;
+int arenaTeams;                     // bindings teams per arena in a tournament
+Match *match = &arenas[0].match;
+Camera2D arenaViews[ARENA_MAX];     // where each arena lands on the virtual screen
+
+// Poll input between frames and don't cap/sync presentation (--low-latency)
+bool lowLatency = false;
+
+// LAN play (--connect): the server owns the match, netClient predicts it here
+NetClient netClient;
+bool networked = false;
+uint32_t victoryMatchId;    // server match the victory screen is showing
+
+// Local matches are recorded; the last finished one is kept for disputes. A match
+// in progress is snapshotted every few seconds so Resume survives a restart.
+#define LAST_REPLAY_PATH "last_match.replay"
+#define RESUME_PATH "resume.sav"
+Replay recording;
+bool recordingValid;        // false for a match resumed from disk (its start wasn't recorded)
+double lastAutosave;
+bool persistMatches = true;     // off: nothing read from or written to disk (tools/bench.c)
+
+// Replay viewer (--replay F)
+Replay viewed;
+ReplayPlayer viewer;
+bool replaying = false;
+int replaySpeed = 1;        // x real time
+
+// Moles, hammers, star and edge/menu boxes, packed in one atlas
+Atlas atlas;
+
+// Sounds
+Sound sndMolePop, sndHitNormal, sndHitGolden, sndHitBomber, sndHitEmpty;
+Sound sndButton, sndVictory;
+
+// Voices per effect; pops can pile up, the victory fanfare never overlaps itself
+SoundPool poolMolePop = { &sndMolePop, 6, 0 };
+SoundPool poolHitNormal = { &sndHitNormal, 4, 1 };
+SoundPool poolHitGolden = { &sndHitGolden, 4, 1 };
+SoundPool poolHitBomber = { &sndHitBomber, 4, 1 };
+SoundPool poolHitEmpty = { &sndHitEmpty, 4, 1 };
+SoundPool poolButton = { &sndButton, 2, 2 };
+SoundPool poolVictory = { &sndVictory, 1, 3 };
+
+// Font
+Font myFont;
+
+// Hit effects: star bursts on golden moles, explosions on bombers, dust on misses
+ParticleEmitter burstGolden, explosionBomber, dustMiss;
+Texture2D particleDot;     // soft round dot, generated at startup
+
+// Gameplay telemetry (--telemetry F): matches are numbered as they start, in every arena
+uint32_t telemetryMatch;
+
+// Tournament results so far, by bindings team
+typedef struct { int wins, points, played; } Standing;
+Standing standings[SIM_MAX_TEAMS];
+int tournamentRounds;
+
+// Pre-decoded asset pack (tools/packer.c); loose files are the fallback
+Pack assetPack;
+
+// Teams and their hole keys (bindings.cfg, or --bindings)
+Bindings bindings;
+
+// Board: hole positions and each hole's red/blue buttons (--board to load a layout)
+BoardLayout board;
+HitGrid hitGrid;
+
+// Pause button
+VirtualButton pauseButton;
+
+// Menu buttons
+GameButton mainMenuButtons[3] = {
+    {{0,0,0,0}, "1. New Game", false},
+    {{0,0,0,0}, "2. Resume", false},
+    {{0,0,0,0}, "3. Exit", false}
+};
+
+GameButton pauseMenuButtons[3] = {
+    {{0,0,0,0}, "1. Resume", false},
+    {{0,0,0,0}, "2. Menu", false},
+    {{0,0,0,0}, "3. Exit", false}
+};
+
+GameButton victoryMenuButtons[3] = {
+    {{0,0,0,0}, "1. Replay", false},
+    {{0,0,0,0}, "2. Menu", false},
+    {{0,0,0,0}, "3. Exit", false}
+};
+
+// Show draw/texture-switch counters (F2)
+bool showRenderStats = false;
+bool showProfiler = false;
+
+// Idle mode: menu-style screens stay in the render target and the loop sleeps in
+// EndDrawing() until there's input (EnableEventWaiting), for kiosks parked on a menu
+bool idleMode = false;
+
+// Process CPU time (all threads: audio, music, loader) over wall time, and how many
+// frames were presented and composed, per ~1 s window for F2 and per idle stretch
+typedef struct {
+    double windowStart, idleStart;
+    clock_t windowCpu, idleCpu;
+    int frames, composes;               // this window
+    int totalFrames, totalComposes;
+    int idleFrames, idleComposes;       // totals when idle mode began
+    float cpuPercent, framesPerSec, composesPerSec;
+} LoadMeter;
+LoadMeter loadMeter;
+
+// ------------------- Text Cache -------------------
+// Static labels are laid out once in BuildTextCache; numbers only when they change
+TextLayout titleText, pausedText, pauseButtonText, waitingText;
+TextLayout winnerTexts[SIM_MAX_TEAMS + 1];     // one per team, then draw
+TextLayout holeIndicators[BINDINGS_MAX_KEYS];
+TextLayout keyLabels[SIM_MAX_TEAMS][BINDINGS_MAX_KEYS];     // on the red and blue edge buttons, by team
+TextLayout standingsTitle, standingsTexts[SIM_MAX_TEAMS];  // best first, rebuilt after each tournament round
+Color standingsColors[SIM_MAX_TEAMS];
+// Match history (--history F): the best scores so far, and after a match each
+// of its teams' record; rebuilt on entering the menu or victory screen
+#define LEADERBOARD_ROWS 5
+TextLayout leaderboardTitle, leaderboardTexts[LEADERBOARD_ROWS];
+int leaderboardRows;
+TextLayout teamRecordTexts[SIM_MAX_TEAMS];
+int teamRecordRows;
+unsigned leaderboardBuilds;     // part of the retained screens' key
+
+char scoreFormats[SIM_MAX_TEAMS][48];     // the team name with any % doubled, then " Team: %d"
+CachedText scoreTexts[SIM_MAX_TEAMS];
+CachedText timerText = { "Time: %d", 40, 2 };
+
+// ------------------- Load Assets -------------------
+// Queues everything on the background loader. The menu group (font, menu
+// background, atlas) is uploaded first so the menu is usable while the
+// game-only assets are still arriving. The web build preloads only the menu
+// group with the page (Makefile.web) and fetches the rest in the background.
+void LoadAssets() {
+    if(PackOpen(&assetPack, "assets.pack")) LoaderUsePack(&assetPack);
+    else TraceLog(LOG_INFO, "LOADER: no assets.pack, decoding loose files");
+
+    // Menu
+    LoaderAdd(ASSET_FONT, ASSET_GROUP_MENU, "assets/font/myfont.ttf", &myFont);
+    LoaderAdd(ASSET_TEXTURE, ASSET_GROUP_MENU, "assets/visual/menu_background.png", &backgroundMenu);
+#if defined(PLATFORM_WEB)
+    // Just the button boxes up front; moles, hammers and the star follow with the game
+    LoaderAddAtlas(ASSET_GROUP_MENU, SPRITE_MASK_BOXES, &atlas);
+    LoaderAddAtlas(ASSET_GROUP_GAME, SPRITE_MASK_ALL & ~SPRITE_MASK_BOXES, &atlas);
+#else
+    LoaderAdd(ASSET_ATLAS, ASSET_GROUP_MENU, NULL, &atlas);    // moles, hammers, star, edge/menu buttons
+#endif
+
+    // Game
+    LoaderAdd(ASSET_SOUND, ASSET_GROUP_GAME, "assets/audio/button.wav", &sndButton);    // clicks are silent until then
+    LoaderAdd(ASSET_TEXTURE, ASSET_GROUP_GAME, "assets/visual/game_background.png", &backgroundGame);
+    LoaderAdd(ASSET_SOUND, ASSET_GROUP_GAME, "assets/audio/mole_pop.wav", &sndMolePop);
+    LoaderAdd(ASSET_SOUND, ASSET_GROUP_GAME, "assets/audio/hit_normal.wav", &sndHitNormal);
+    LoaderAdd(ASSET_SOUND, ASSET_GROUP_GAME, "assets/audio/hit_golden.wav", &sndHitGolden);
+    LoaderAdd(ASSET_SOUND, ASSET_GROUP_GAME, "assets/audio/hit_bomber.wav", &sndHitBomber);
+    LoaderAdd(ASSET_SOUND, ASSET_GROUP_GAME, "assets/audio/hit_empty.wav", &sndHitEmpty);
+    LoaderAdd(ASSET_SOUND, ASSET_GROUP_GAME, "assets/audio/victory.ogg", &sndVictory);
+    LoaderAdd(ASSET_FILE, ASSET_GROUP_GAME, "assets/audio/bgm.ogg", NULL);     // opened by MusicStart()
+
+    LoaderStart(0);
+}
+
+// ------------------- Loading Screen -------------------
+// Uses raylib's built-in font: ours may not be loaded yet
+void DrawLoadingScreen(float progress){
+    BeginDrawing();
+    RenderBegin();
+    int barWidth = 600;
+    int x = SCREEN_WIDTH/2 - barWidth/2, y = SCREEN_HEIGHT/2;
+    DrawText("Loading...", x, y - 50, 30, RAYWHITE);
+    DrawRectangleLines(x, y, barWidth, 24, GRAY);
+    DrawRectangle(x + 2, y + 2, (int)((barWidth - 4)*progress), 20, GOLD);
+    RenderEnd();
+    EndDrawing();
+}
+
+// ------------------- Build Text Cache -------------------
+// Call again whenever the font or key bindings change
+void BuildTextCache() {
+    TextLayoutBuild(&titleText, myFont, "Whac-A-Mole", 70, 5);
+    TextLayoutBuild(&pausedText, myFont, "PAUSED", 80, 5);
+    TextLayoutBuild(&pauseButtonText, myFont, "PAUSE", 40, 2);
+    TextLayoutBuild(&waitingText, myFont, "Waiting for server...", 60, 3);
+    for(int t=0;t<bindings.teamCount;t++){
+        TextLayoutBuild(&winnerTexts[t], myFont, TextFormat("%s Team Wins!", bindings.names[t]), 70, 5);
+        // The name comes from bindings.cfg and ends up inside a format string
+        char *f = scoreFormats[t];
+        for(const char *c = bindings.names[t];*c;c++){
+            if(*c == '%') *f++ = '%';
+            *f++ = *c;
+        }
+        strcpy(f, " Team: %d");
+        scoreTexts[t] = (CachedText){ scoreFormats[t], 40, 2 };
+    }
+    TextLayoutBuild(&winnerTexts[SIM_MAX_TEAMS], myFont, "Match Draw!", 70, 5);
+
+    for(int i=0;i<3;i++){
+        TextLayoutBuild(&mainMenuButtons[i].text, myFont, mainMenuButtons[i].label, 50, 2);
+        TextLayoutBuild(&pauseMenuButtons[i].text, myFont, pauseMenuButtons[i].label, 50, 2);
+        TextLayoutBuild(&victoryMenuButtons[i].text, myFont, victoryMenuButtons[i].label, 50, 2);
+    }
+
+    for(int i=0;i<BINDINGS_MAX_KEYS;i++){
+        // Format: "Z - B", every team's key for the hole in team order
+        char indicator[SIM_MAX_TEAMS*(16 + 3)] = "";
+        for(int t=0;t<bindings.teamCount;t++){
+            if(i >= bindings.keyCount[t] || !bindings.keys[t][i]) continue;
+            if(indicator[0]) strcat(indicator, " - ");
+            strcat(indicator, bindings.keyNames[t][i]);
+        }
+        TextLayoutBuild(&holeIndicators[i], myFont, indicator, 30, 1);
+        for(int t=0;t<bindings.teamCount;t++){
+            TextLayoutBuild(&keyLabels[t][i], myFont, (i < bindings.keyCount[t]) ? bindings.keyNames[t][i] : "", 30, 1);
+        }
+    }
+
+    CachedTextInvalidate(&timerText);
+}
+
+// ------------------- Sim Events -------------------
+// Records of what happened, for balancing; replays would only repeat the original's.
+// Teams are bindings teams, so tournament rows say who played.
+void PushTelemetry(Arena *a, const SimEvent *event){
+    if(!TelemetryEnabled() || replaying) return;
+    const Match *m = &a->match;
+    TelemetryEvent rec = { .time = GetTime(), .match = a->serial, .tick = event->tick, .hole = (int16_t)event->hole,
+                           .team = (int8_t)(event->team >= 0 ? a->firstTeam + event->team : -1), .moleType = (int8_t)event->moleType };
+    switch(event->type){
+        case SIM_EVENT_MOLE_POP:
+            rec.type = TEL_MOLE_SPAWN;
+            break;
+        case SIM_EVENT_HIT:
+            rec.type = event->moleType < 0 ? TEL_MISS : TEL_HIT;
+            rec.score = event->value;
+            if(event->moleType >= 0) rec.value = (int32_t)(event->age*SIM_DT*1000.0f);
+            break;
+        case SIM_EVENT_MOLE_EXPIRE:
+            rec.type = TEL_MOLE_EXPIRE;
+            rec.value = event->value;
+            break;
+        case SIM_EVENT_ROUND_OVER:
+            rec.type = TEL_MATCH_END;
+            for(int t=0;t<m->teamCount;t++){
+                rec.team = (int8_t)(a->firstTeam + t);
+                rec.score = m->scores[t];
+                TelemetryPush(&rec);
+            }
+            return;
+    }
+    TelemetryPush(&rec);
+}
+
+// The simulation reports what happened; the game decides what it sounds and looks like.
+// user is the arena; effects are drawn on the whole screen, so bursts go where its view puts the hole.
+void OnSimEvent(void *user, const SimEvent *event){
+    Arena *a = user;
+    PushTelemetry(a, event);
+    switch(event->type){
+        case SIM_EVENT_MOLE_POP: PlayPooled(&poolMolePop); break;
+        case SIM_EVENT_HIT: {
+            SimVec2 hole = a->match.board->pos[event->hole];
+            Vector2 at = GetWorldToScreen2D((Vector2){hole.x, hole.y}, arenaViews[a - arenas]);
+            switch(event->moleType){
+                case MOLE_NORMAL: PlayPooled(&poolHitNormal); break;
+                case MOLE_GOLDEN: PlayPooled(&poolHitGolden); ParticleBurst(&burstGolden, at.x, at.y, 24); break;
+                case MOLE_BOMBER: PlayPooled(&poolHitBomber); ParticleBurst(&explosionBomber, at.x, at.y, 60); break;
+                default: PlayPooled(&poolHitEmpty); ParticleBurst(&dustMiss, at.x, at.y + 40*arenaViews[a - arenas].zoom, 16); break;
+            }
+        } break;
+        case SIM_EVENT_ROUND_OVER: break;
+        case SIM_EVENT_MOLE_EXPIRE: break;
+    }
+}
+
+// ------------------- Effects -------------------
+void InitEffects(){
+    // A failed emitter stays empty and drops its spawns; the game runs without that effect
+    bool ok = ParticleEmitterInit(&burstGolden, (ParticleStyle){ 250, 600, PI, 10, 22, 0.5f, 0.9f, 600, 1.5f,
+        (Color){255, 220, 80, 255}, (Color){255, 255, 255, 255} }, 512);
+    ok &= ParticleEmitterInit(&explosionBomber, (ParticleStyle){ 150, 700, PI, 14, 40, 0.3f, 0.7f, -50, 3.0f,
+        (Color){255, 200, 60, 255}, (Color){120, 30, 10, 255} }, 1024);
+    ok &= ParticleEmitterInit(&dustMiss, (ParticleStyle){ 40, 160, 1.2f, 8, 20, 0.4f, 0.8f, 120, 2.5f,
+        (Color){170, 140, 100, 200}, (Color){120, 100, 80, 200} }, 512);
+    if(!ok) TraceLog(LOG_WARNING, "PARTICLES: out of memory, some effects are disabled");
+    Image dot = GenImageGradientRadial(32, 32, 0.0f, WHITE, BLANK);
+    particleDot = LoadTextureFromImage(dot);
+    UnloadImage(dot);
+}
+
+void UpdateEffects(double now){
+    static double last = 0;
+    float dt = (last > 0 && now - last < 0.05) ? (float)(now - last) : 0.05f;     // long gaps (pauses) count as one frame
+    last = now;
+    ParticlesUpdate(&burstGolden, dt);
+    ParticlesUpdate(&explosionBomber, dt);
+    ParticlesUpdate(&dustMiss, dt);
+}
+
+void ClearEffects(){
+    ParticlesClear(&burstGolden);
+    ParticlesClear(&explosionBomber);
+    ParticlesClear(&dustMiss);
+}
+
+void UnloadEffects(){
+    ParticleEmitterFree(&burstGolden);
+    ParticleEmitterFree(&explosionBomber);
+    ParticleEmitterFree(&dustMiss);
+    UnloadTexture(particleDot);
+}
+
+// ------------------- Initialize Game -------------------
+void PushMatchStart(Arena *a){
+    a->serial = ++telemetryMatch;
+    TelemetryEvent rec = { .time = GetTime(), .match = a->serial, .type = TEL_MATCH_START,
+                           .value = a->match.teamCount, .hole = -1, .team = -1, .moleType = -1 };
+    if(!replaying) TelemetryPush(&rec);
+}
+
+// Tournament: every arena starts a fresh local match at once. Their events wait in
+// the arena while the workers step them (DispatchArenaEvents). Nothing is
+// recorded or resumed.
+void InitArenas(uint64_t *matchCount){
+    Vector2 hammerSize = SpriteSize(&atlas, SPRITE_HAMMER_RED);
+    double now = GetTime();
+    for(int k=0;k<arenaCount;k++){
+        Arena *a = &arenas[k];
+        a->match.onEvent = ArenaQueueEvent;
+        a->match.eventUser = a;
+        a->match.board = &board.holes;
+        a->match.teamCount = arenaTeams;
+        a->match.hammerSize = (SimVec2){hammerSize.x, hammerSize.y};
+        a->firstTeam = k*arenaTeams;
+        a->hitCount = a->eventCount = 0;
+        SimInit(&a->match, (uint64_t)time(NULL) ^ ((*matchCount)++ << 32));
+        a->simClock = now;
+        PushMatchStart(a);
+    }
+}
+
+void InitGame() {
+    ClearEffects();
+    static uint64_t matchCount = 0;
+    if(arenaCount > 1) InitArenas(&matchCount);
+    else{
+        match->onEvent = OnSimEvent;
+        match->eventUser = &arenas[0];
+        if(replaying){
+            // The replay brings its own board, teams and seed
+            ReplayPlayerSeek(&viewer, 0);
+            arenas[0].simClock = GetTime();
+        }else{
+            match->board = &board.holes;
+            match->teamCount = bindings.teamCount;
+            Vector2 hammerSize = SpriteSize(&atlas, SPRITE_HAMMER_RED);
+            match->hammerSize = (SimVec2){hammerSize.x, hammerSize.y};
+        }
+        // Online, the server starts matches and its snapshots fill in the state
+        if(!networked && !replaying){
+            uint64_t seed = (uint64_t)time(NULL) ^ (matchCount++ << 32);
+            SimInit(match, seed);
+            ReplayBegin(&recording, match, seed);
+            recordingValid = true;
+            arenas[0].simClock = GetTime();
+            lastAutosave = arenas[0].simClock;
+        }
+        PushMatchStart(&arenas[0]);
+    }
+
+    // Pause button
+    pauseButton.rect = (Rectangle){SCREEN_WIDTH/2-100, SCREEN_HEIGHT-150, 200, 80};
+
+    // Menu button rectangles
+    for(int i=0;i<3;i++){
+        mainMenuButtons[i].rect = (Rectangle){SCREEN_WIDTH/2-200, 300 + i*100, 400, 60};
+        pauseMenuButtons[i].rect = (Rectangle){SCREEN_WIDTH/2-200, 300 + i*100, 400, 60};
+        victoryMenuButtons[i].rect = (Rectangle){SCREEN_WIDTH/2-200, 300 + i*100, 400, 60};
+    }
+}
+
+// ------------------- Keyboard & Mouse Input -------------------
+// Hits are queued by InputDrain() (input.c) through the bindings table and the
+// board's hit grid; the menus read the same drained presses.
+
+// Runs whole ticks up to time t (online: as far as the server's clock allows)
+void AdvanceSimTo(double t){
+    if(networked){
+        NetClientUpdate(&netClient, t);
+        arenas[0].simClock = netClient.clock;
+        return;
+    }
+    if(t - arenas[0].simClock > 0.25) arenas[0].simClock = t - 0.25;   // long hitch: drop time rather than spiral
+    while(arenas[0].simClock + SIM_DT <= t && !SimIsOver(match)){
+        SimStep(match, NULL);
+        arenas[0].simClock += SIM_DT;
+    }
+}
+
+// Each hit lands on the board as it was at its press time: ticks run up to the
+// press, then the hit is applied before the next tick moves anything
+void ApplyInputEvents(){
+    InputEvent ev;
+    while(InputPop(&ev)){
+        if(arenaCount > 1){
+            // Tournament: the team's arena applies it in the tick it was struck in
+            int k = ev.team/arenaTeams;
+            if(k < arenaCount) ArenaHitAt(&arenas[k], ev.time, ev.hole, ev.team % arenaTeams);
+            LatencyOnHit(ev.time, GetTime());
+            continue;
+        }
+        AdvanceSimTo(ev.time);
+        if(SimIsOver(match)) continue;
+        // Online every bound key strikes for the team the server gave us
+        if(networked) NetClientHit(&netClient, ev.hole);
+        else{
+            ReplayRecordHit(&recording, match, ev.hole, ev.team);
+            SimHit(match, ev.hole, ev.team);
+        }
+        LatencyOnHit(ev.time, GetTime());
+    }
+}
+
+// Tournament: all arenas step in parallel, then their sounds and effects play here
+void AdvanceArenas(double now){
+    ArenasAdvance(arenas, arenaCount, now);
+    for(int k=0;k<arenaCount;k++){
+        Arena *a = &arenas[k];
+        for(int e=0;e<a->eventCount;e++) OnSimEvent(a, &a->events[e]);
+        a->eventCount = 0;
+    }
+}
+
+bool MatchesOver(){
+    for(int k=0;k<arenaCount;k++) if(!SimIsOver(&arenas[k].match)) return false;
+    return true;
+}
+
+// After a pause the matches pick up from now rather than catching up
+void ResyncClocks(double now){
+    for(int k=0;k<arenaCount;k++) arenas[k].simClock = now;
+}
+
+// Adds a finished tournament round to the standings and lays them out, best first
+void RecordTournamentRound(){
+    for(int k=0;k<arenaCount;k++){
+        const Match *m = &arenas[k].match;
+        int winner = SimWinner(m);
+        for(int t=0;t<m->teamCount;t++){
+            Standing *st = &standings[arenas[k].firstTeam + t];
+            st->played++;
+            st->points += m->scores[t];
+            if(t == winner) st->wins++;
+        }
+    }
+    tournamentRounds++;
+
+    // Wins, then points
+    int order[SIM_MAX_TEAMS], teams = arenaCount*arenaTeams;
+    for(int i=0;i<teams;i++){
+        int j = i;
+        while(j > 0 && (standings[order[j-1]].wins < standings[i].wins ||
+              (standings[order[j-1]].wins == standings[i].wins && standings[order[j-1]].points < standings[i].points))){
+            order[j] = order[j-1];
+            j--;
+        }
+        order[j] = i;
+    }
+    TextLayoutBuild(&standingsTitle, myFont, TextFormat("Round %d standings", tournamentRounds), 60, 4);
+    for(int i=0;i<teams;i++){
+        const Standing *st = &standings[order[i]];
+        TextLayoutBuild(&standingsTexts[i], myFont, TextFormat("%d. %s: %d wins, %d pts", i + 1, bindings.names[order[i]],
+                        st->wins, st->points), 36, 2);
+        standingsColors[i] = bindings.colors[order[i]];
+    }
+    TraceLog(LOG_INFO, "ARENA: round %d over in %d arenas", tournamentRounds, arenaCount);
+}
+
+// Every arena's finished match into the history log (written off this thread)
+void RecordHistory(){
+    for(int k=0;k<arenaCount;k++){
+        const Arena *a = &arenas[k];
+        const char *names[SIM_MAX_TEAMS];
+        for(int t=0;t<a->match.teamCount;t++) names[t] = bindings.names[a->firstTeam + t];
+        HistoryAddMatch(a->match.teamCount, names, a->match.scores, SimWinner(&a->match));
+    }
+}
+
+void BuildLeaderboard(){
+    leaderboardBuilds++;
+    leaderboardRows = teamRecordRows = 0;
+    if(!HistoryEnabled()) return;
+    HistoryRecord best[LEADERBOARD_ROWS];
+    leaderboardRows = HistoryTopScores(best, LEADERBOARD_ROWS);
+    TextLayoutBuild(&leaderboardTitle, myFont, TextFormat("Best of %u matches", HistoryMatchCount()), 40, 2);
+    for(int i=0;i<leaderboardRows;i++){
+        char date[16] = "";
+        time_t when = (time_t)best[i].time;
+        struct tm *local = localtime(&when);
+        if(local) strftime(date, sizeof(date), "%Y-%m-%d", local);
+        TextLayoutBuild(&leaderboardTexts[i], myFont, TextFormat("%d. %s %d  %s", i + 1, best[i].team, best[i].score, date), 30, 1);
+    }
+
+    // A tournament has its standings instead
+    if(currentState != STATE_VICTORY || arenaCount > 1) return;
+    for(int t=0;t<match->teamCount;t++){
+        HistoryTeam team;
+        HistoryTeamStats(bindings.names[t], &team);
+        TextLayoutBuild(&teamRecordTexts[teamRecordRows++], myFont, TextFormat("%s: won %u of %u (%u%%), best %d", bindings.names[t],
+                        team.wins, team.matches, team.matches ? 100*team.wins/team.matches : 0, team.best), 30, 1);
+    }
+}
+
+// Tournament arenas in a grid of equal cells, each a scaled copy of the full screen
+void LayoutArenas(){
+    int cols = 1;
+    while(cols*cols < arenaCount) cols++;
+    int rows = (arenaCount + cols - 1)/cols;
+    float zoom = 1.0f/cols, cellW = SCREEN_WIDTH*zoom, cellH = SCREEN_HEIGHT*zoom;
+    float x0 = (SCREEN_WIDTH - cols*cellW)/2, y0 = (SCREEN_HEIGHT - rows*cellH)/2;
+    for(int k=0;k<arenaCount;k++){
+        arenaViews[k] = (Camera2D){ .offset = { x0 + (k % cols)*cellW, y0 + (k / cols)*cellH }, .zoom = zoom };
+    }
+}
+
+// Replay viewer: ticks at replaySpeed x real time, silent when too fast to follow.
+// Left/Right scrub 5 s, Up/Down change speed, bound keys do nothing.
+void AdvanceReplay(double now){
+    InputEvent ev;
+    while(InputPop(&ev)){}
+
+    if(InputKeyPressed(KEY_UP) && replaySpeed < 256) replaySpeed *= 2;
+    if(InputKeyPressed(KEY_DOWN) && replaySpeed > 1) replaySpeed /= 2;
+    int scrub = (InputKeyPressed(KEY_RIGHT) - InputKeyPressed(KEY_LEFT))*5*SIM_TICK_HZ;
+    if(scrub){
+        int target = (int)match->tick + scrub;
+        ReplayPlayerSeek(&viewer, target < 0 ? 0 : (uint32_t)target);
+        arenas[0].simClock = now;
+    }
+
+    double dt = SIM_DT/(double)replaySpeed;
+    if(now - arenas[0].simClock > 0.25) arenas[0].simClock = now - 0.25;
+    SimEventFn onEvent = match->onEvent;
+    if(replaySpeed > 2) match->onEvent = NULL;
+    while(arenas[0].simClock + dt <= now && ReplayPlayerStep(&viewer)) arenas[0].simClock += dt;
+    match->onEvent = onEvent;
+}
+
+// Local match in progress -> RESUME_PATH
+void SaveResume(){
+    if(networked || replaying || arenaCount > 1 || !persistMatches) return;
+    if(currentState != STATE_GAME && currentState != STATE_PAUSE) return;
+    if(!MatchSaveFile(match, RESUME_PATH)) TraceLog(LOG_WARNING, "REPLAY: cannot write %s", RESUME_PATH);
+}
+
+// Low-latency mode: instead of sleeping until the next frame, poll input at ~1 kHz
+// and apply hits as they arrive. The first pass handles what EndDrawing() polled.
+void DrainInputUntil(double deadline){
+    InputFrameClear();
+    do{
+        double now = GetTime();
+        InputDrain(now, currentState == STATE_GAME);
+        if(currentState == STATE_GAME) ApplyInputEvents();
+        if(now >= deadline) break;
+        WaitTime(0.001);
+        PollInputEvents();
+    }while(true);
+}
+
+// Normal mode caps the frame rate here rather than in EndDrawing(), so the
+// render-scale controller sees the frame's cost without the wait
+void PaceFrame(double frameStart, double hz){
+    double wait = frameStart + 1.0/hz - GetTime();
+    if(wait > 0) WaitTime(wait);
+}
+
+// CPU share of wall time since a point; clock() is process time except on
+// Windows, where it's wall time and this reads 100%
+float CpuPercent(clock_t cpuSince, double wallSince){
+    double wall = GetTime() - wallSince;
+    return wall > 0 ? (float)(100.0*(clock() - cpuSince)/CLOCKS_PER_SEC/wall) : 0.0f;
+}
+
+void UpdateLoadMeter(bool composed){
+    LoadMeter *m = &loadMeter;
+    m->frames++; m->totalFrames++;
+    if(composed){ m->composes++; m->totalComposes++; }
+    double elapsed = GetTime() - m->windowStart;
+    if(elapsed < 1.0) return;
+    m->cpuPercent = CpuPercent(m->windowCpu, m->windowStart);
+    m->framesPerSec = (float)(m->frames/elapsed);
+    m->composesPerSec = (float)(m->composes/elapsed);
+    m->windowStart = GetTime();
+    m->windowCpu = clock();
+    m->frames = m->composes = 0;
+}
+
+// Nothing on a menu-style screen moves until there's input, unless something
+// still needs the loop: loading, the network link, music startup, low-latency polling
+bool CanIdle(){
+#if defined(PLATFORM_WEB)
+    return false;       // the browser drives the loop (ASYNCIFY) and already throttles hidden tabs
+#else
+    return currentState != STATE_GAME && LoaderDone() && !networked && !lowLatency && !MusicNeedsUpdates();
+#endif
+}
+
+void SetIdleMode(bool idle){
+    LoadMeter *m = &loadMeter;
+    idleMode = idle;
+    if(idle){
+        EnableEventWaiting();
+        m->idleStart = GetTime();
+        m->idleCpu = clock();
+        m->idleFrames = m->totalFrames;
+        m->idleComposes = m->totalComposes;
+    }else{
+        DisableEventWaiting();
+        TraceLog(LOG_INFO, "IDLE: %.0f s, cpu %.2f%%, %d frames presented, %d composed", GetTime() - m->idleStart,
+                 CpuPercent(m->idleCpu, m->idleStart), m->totalFrames - m->idleFrames, m->totalComposes - m->idleComposes);
+    }
+}
+
+// Three-button menus: one lookup for the button under the mouse (hover), then the
+// chosen index from a click or the 1/2/3 keys, or -1
+int MenuChoice(GameButton buttons[3], Vector2 mousePos){
+    static const int keys[3] = { KEY_ONE, KEY_TWO, KEY_THREE };
+    int hovered = -1;
+    for(int i=0;i<3;i++){
+        buttons[i].isHovered = false;
+        if(hovered < 0 && CheckCollisionPointRec(mousePos, buttons[i].rect)) hovered = i;
+    }
+    if(hovered >= 0){
+        buttons[hovered].isHovered = true;
+        if(InputMousePressed()){
+            PlayPooled(&poolButton);
+            return hovered;
+        }
+    }
+    for(int i=0;i<3;i++) if(InputKeyPressed(keys[i])) return i;
+    return -1;
+}
+
+// Every transition goes through here so telemetry sees it (not a replay's)
+void SetState(GameState state){
+    currentState = state;
+    if(!replaying){
+        TelemetryEvent rec = { .time = GetTime(), .match = telemetryMatch, .tick = match->tick, .type = TEL_STATE,
+                               .value = state, .hole = -1, .team = -1, .moleType = -1 };
+        TelemetryPush(&rec);
+    }
+    if(state == STATE_MENU || state == STATE_VICTORY) BuildLeaderboard();
+}
+
+    // ------------------- Main Game Loop Input & State -------------------
+void UpdateGameState(double now, Vector2 mousePos, bool *gamePaused){
+    // ------------------- Menu State -------------------
+    if(currentState == STATE_MENU){
+        // New Game/Resume wait for the game-only assets
+        bool gameReady = LoaderGroupReady(ASSET_GROUP_GAME);
+        int choice = MenuChoice(mainMenuButtons, mousePos);
+        mainMenuButtons[0].isDisabled = mainMenuButtons[1].isDisabled = !gameReady;
+
+        if(gameReady && choice == 0){
+            InitGame(); SetState(STATE_GAME); *gamePaused=false;
+        }
+        if(gameReady && choice == 1){
+            SetState(STATE_GAME); *gamePaused=false; ResyncClocks(now);
+        }
+        if(choice == 2){
+            CloseWindow(); exit(0);
+        }
+    }
+
+    // ------------------- Game State -------------------
+    else if(currentState == STATE_GAME){
+        // Hits drained this frame (already applied between frames in
+        // low-latency mode), then moles and hammer movement in fixed ticks up to now
+        if(replaying) AdvanceReplay(now);
+        else{
+            ApplyInputEvents();
+            if(arenaCount > 1) AdvanceArenas(now);
+            else AdvanceSimTo(now);
+        }
+        UpdateEffects(now);
+
+        if(MatchesOver() && (!networked || netClient.live)){
+            if(!replaying) RecordHistory();
+            SetState(STATE_VICTORY);
+            victoryMatchId = netClient.matchId;
+            PlayPooled(&poolVictory);
+            if(arenaCount > 1) RecordTournamentRound();
+            else if(!networked && !replaying && persistMatches){
+                if(recordingValid){
+                    ReplayEnd(&recording, match);
+                    if(ReplaySave(&recording, LAST_REPLAY_PATH)) TraceLog(LOG_INFO, "REPLAY: saved %s", LAST_REPLAY_PATH);
+                }
+                remove(RESUME_PATH);
+            }
+        }
+        else if(!networked && !replaying && now - lastAutosave >= 5.0){
+            SaveResume();
+            lastAutosave = now;
+        }
+
+        // Pause
+        if(InputMousePressed() && CheckCollisionPointRec(mousePos, pauseButton.rect)){
+            SetState(STATE_PAUSE);
+            PlayPooled(&poolButton);
+            *gamePaused = true;
+        }
+        if(InputKeyPressed(KEY_SPACE)){
+            SetState(STATE_PAUSE);
+            PlayPooled(&poolButton);
+            *gamePaused = true;
+        }
+    }
+
+    // ------------------- Pause State -------------------
+    else if(currentState == STATE_PAUSE){
+        int choice = MenuChoice(pauseMenuButtons, mousePos);
+
+        if(choice == 0){
+            SetState(STATE_GAME); *gamePaused=false; ResyncClocks(now);
+        }
+        if(choice == 1){
+            SaveResume();
+            SetState(STATE_MENU);
+        }
+        if(choice == 2){
+            SaveResume();
+            CloseWindow(); exit(0);
+        }
+    }
+
+    // ------------------- Victory State -------------------
+    else if(currentState == STATE_VICTORY){
+        int choice = MenuChoice(victoryMenuButtons, mousePos);
+        // Online, replay means the server's next match
+        victoryMenuButtons[0].isDisabled = networked && netClient.matchId == victoryMatchId;
+
+        if(choice == 0 && !victoryMenuButtons[0].isDisabled){
+            InitGame(); SetState(STATE_GAME); *gamePaused=false;
+        }
+        if(choice == 1){
+            SetState(STATE_MENU);
+        }
+        if(choice == 2){
+            CloseWindow(); exit(0);
+        }
+    }
+}
+    // ------------------- Drawing Function -------------------
+// Sprite for a mole, or -1 for an empty hole
+int MoleSprite(int type, bool isHit){
+    switch(type){
+        case MOLE_NORMAL: return isHit ? SPRITE_MOLE_NORMAL_HIT : SPRITE_MOLE_NORMAL;
+        case MOLE_GOLDEN: return isHit ? SPRITE_MOLE_GOLDEN_HIT : SPRITE_MOLE_GOLDEN;
+        case MOLE_BOMBER: return isHit ? SPRITE_MOLE_BOMBER_HIT : SPRITE_MOLE_BOMBER;
+        default: return -1;
+    }
+}
+
+// Menu-style screens share a layout: boxes from the atlas, then all labels
+void DrawMenuButtons(const GameButton buttons[3]){
+    for(int i=0;i<3;i++) DrawSprite(&atlas, SPRITE_BOX_BLACK, buttons[i].rect.x, buttons[i].rect.y, WHITE);
+    for(int i=0;i<3;i++){
+        Color textColor = buttons[i].isDisabled ? GRAY : buttons[i].isHovered ? YELLOW : WHITE;
+        DrawTextLayout(myFont, &buttons[i].text, (Vector2){buttons[i].rect.x + 20, buttons[i].rect.y + 10}, textColor);
+    }
+}
+
+// What a menu-style screen shows besides its state: hovered and disabled buttons, the winner
+unsigned ScreenKey(){
+    const GameButton *buttons = (currentState == STATE_MENU) ? mainMenuButtons
+                              : (currentState == STATE_PAUSE) ? pauseMenuButtons : victoryMenuButtons;
+    unsigned key = currentState;
+    for(int i=0;i<3;i++) key |= (unsigned)buttons[i].isHovered << (2 + i) | (unsigned)buttons[i].isDisabled << (5 + i);
+    if(currentState == STATE_VICTORY) key |= (unsigned)(SimWinner(match) + 1) << 8 | (unsigned)tournamentRounds << 12;
+    return key ^ leaderboardBuilds << 20;
+}
+
+// Right of the menu buttons
+void DrawLeaderboard(){
+    if(leaderboardRows == 0) return;
+    DrawTextLayout(myFont, &leaderboardTitle, (Vector2){SCREEN_WIDTH - 560, 300}, GOLD);
+    for(int i=0;i<leaderboardRows;i++) DrawTextLayout(myFont, &leaderboardTexts[i], (Vector2){SCREEN_WIDTH - 560, 360 + i*45}, WHITE);
+}
+
+// One match: board, moles, scores and hammers in full-screen virtual coordinates
+// (a tournament places it with arenaViews). Teams are the arena's own; their
+// names, colors and keys come from the bindings team each one is.
+void DrawArena(const Arena *a){
+    const Rectangle screenRect = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
+    const Match *m = &a->match;
+    DrawTextureRectCounted(backgroundGame, screenRect, WHITE);
+
+    // Loaded layouts don't match the holes painted on the background
+    const SimBoard *holes = &board.holes;
+    if(board.custom){
+        for(int i=0;i<holes->holeCount;i++) DrawEllipse(holes->pos[i].x, holes->pos[i].y + 40, 70, 22, Fade(BLACK, 0.6f));
+    }
+
+    // Atlas: visible moles only, then left & right edge buttons
+    const SimMoles *moles = &m->moles;
+    for(int k=0;k<moles->activeCount;k++){
+        int i = moles->activeHole[k];
+        int sprite = MoleSprite(moles->type[i], SimMoleHit(moles, i));
+        if(sprite < 0) continue;
+        Vector2 size = SpriteSize(&atlas, sprite);
+        DrawSprite(&atlas, sprite, holes->pos[i].x - (int)size.x/2, holes->pos[i].y - (int)size.y/2, WHITE);
+    }
+    for(int i=0;i<holes->holeCount;i++){
+        BoardRect r = board.redButtons[i], b = board.blueButtons[i];
+        DrawSpriteRect(&atlas, SPRITE_BOX_RED, (Rectangle){r.x, r.y, r.width, r.height}, WHITE);
+        DrawSpriteRect(&atlas, SPRITE_BOX_BLUE, (Rectangle){b.x, b.y, b.width, b.height}, WHITE);
+    }
+
+    // Font: scores & timer, hole indicators, edge button keys
+    // Even teams down the left, odd teams down the right
+    for(int t=0;t<m->teamCount;t++){
+        int team = a->firstTeam + t;
+        Vector2 pos = { (t % 2) ? SCREEN_WIDTH-350 : 30, 30 + (t/2)*50 };
+        DrawTextLayout(myFont, CachedTextGet(&scoreTexts[team], myFont, m->scores[t]), pos, bindings.colors[team]);
+    }
+    DrawTextLayout(myFont, CachedTextGet(&timerText, myFont, (int)m->timer), (Vector2){SCREEN_WIDTH/2-50,30}, YELLOW);
+
+    // Hole indicators list every team's key, so only a single match has them
+    int keyed = (holes->holeCount < BINDINGS_MAX_KEYS) ? holes->holeCount : BINDINGS_MAX_KEYS;
+    for(int i=0;i<keyed && arenaCount == 1;i++){
+        DrawTextLayout(myFont, &holeIndicators[i],
+            (Vector2){holes->pos[i].x - holeIndicators[i].size.x/2, holes->pos[i].y + 60}, WHITE);
+    }
+    for(int i=0;i<keyed;i++){
+        if(m->teamCount > 0) DrawTextLayout(myFont, &keyLabels[a->firstTeam][i], (Vector2){board.redButtons[i].x+10, board.redButtons[i].y+10}, WHITE);
+        if(m->teamCount > 1) DrawTextLayout(myFont, &keyLabels[a->firstTeam + 1][i], (Vector2){board.blueButtons[i].x+10, board.blueButtons[i].y+10}, WHITE);
+    }
+
+    // Atlas: hammers, interpolated between the last two ticks
+    float alpha = (float)((GetTime() - a->simClock)/SIM_DT);
+    if(alpha > 1.0f) alpha = 1.0f;
+    // Teams past red and blue reuse their side's hammer, tinted
+    for(int t=0;t<m->teamCount;t++){
+        const SimHammer *h = &m->hammers[t];
+        SimVec2 p = SimHammerLerp(h, alpha);
+        SpriteId sprite = (t % 2) ? (h->isHitting ? SPRITE_HAMMER_BLUE_HIT : SPRITE_HAMMER_BLUE)
+                                  : (h->isHitting ? SPRITE_HAMMER_RED_HIT : SPRITE_HAMMER_RED);
+        DrawSprite(&atlas, sprite, p.x, p.y, (t < 2) ? WHITE : bindings.colors[a->firstTeam + t]);
+    }
+}
+
+    // ------------------- Drawing Function -------------------
+// Draws are grouped by texture (background, atlas, font) so raylib can batch
+// each group; the order inside a group keeps the original layering.
+// Everything goes to the scaled render target; the caller adds the overlays
+// and ends the frame, so the present can be timed on its own.
+// Menu-style screens are retained: returns false when the kept image was reused.
+bool DrawGame(Vector2 mousePos){
+    (void)mousePos;
+    const Rectangle screenRect = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };    // backgrounds may be loaded smaller
+    BeginDrawing();
+    bool composed = true;
+    if(currentState == STATE_GAME) RenderBegin();
+    else composed = RenderBeginRetained(ScreenKey());
+    RenderStatsBeginFrame();
+
+    if(!composed){}     // unchanged since it was drawn
+
+    // ------------------- Menu -------------------
+    else if(currentState == STATE_MENU){
+        DrawTextureRectCounted(backgroundMenu, screenRect, WHITE);
+        DrawMenuButtons(mainMenuButtons);
+        DrawTextLayout(myFont, &titleText, (Vector2){SCREEN_WIDTH/2 - titleText.size.x/2, 150}, GOLD);
+        DrawLeaderboard();
+    }
+
+    // ------------------- Game -------------------
+    else if(currentState == STATE_GAME){
+        for(int k=0;k<arenaCount;k++){
+            if(arenaCount > 1) BeginMode2D(arenaViews[k]);
+            DrawArena(&arenas[k]);
+            if(arenaCount > 1) EndMode2D();
+        }
+
+        // Effects over every arena: stars from the atlas, then the dot emitters, one batch each
+        const SpriteRect *star = &atlas.sprites[SPRITE_STAR];
+        ParticlesDraw(&burstGolden, atlas.pages[star->page], star->rect);
+        ParticlesDraw(&explosionBomber, particleDot, (Rectangle){0, 0, particleDot.width, particleDot.height});
+        ParticlesDraw(&dustMiss, particleDot, (Rectangle){0, 0, particleDot.width, particleDot.height});
+
+        // Atlas: the pause button, then its label and status text
+        DrawSprite(&atlas, SPRITE_BOX_GREEN, pauseButton.rect.x, pauseButton.rect.y, WHITE);
+
+        DrawTextLayout(myFont, &pauseButtonText, (Vector2){pauseButton.rect.x+20, pauseButton.rect.y+15}, WHITE);
+        if(networked && !netClient.live){
+            DrawTextLayout(myFont, &waitingText, (Vector2){SCREEN_WIDTH/2 - waitingText.size.x/2, SCREEN_HEIGHT/2 - 200}, YELLOW);
+        }
+        if(replaying){
+            int at = (int)(match->tick/SIM_TICK_HZ), end = (int)(viewer.endTick/SIM_TICK_HZ);
+            DrawText(TextFormat("REPLAY %dx  %d:%02d / %d:%02d  %s   Left/Right: scrub  Up/Down: speed", replaySpeed,
+                at/60, at%60, end/60, end%60, viewed.finished ? (viewer.verified ? "verified" : "MISMATCH") : "unfinished"),
+                SCREEN_WIDTH/2 - 420, SCREEN_HEIGHT - 200, 24, viewer.verified ? WHITE : RED);
+        }
+    }
+
+    // ------------------- Pause -------------------
+    else if(currentState == STATE_PAUSE){
+        DrawTextureRectCounted(backgroundMenu, screenRect, WHITE);
+        DrawMenuButtons(pauseMenuButtons);
+        DrawTextLayout(myFont, &pausedText, (Vector2){SCREEN_WIDTH/2 - pausedText.size.x/2,150}, YELLOW);
+    }
+
+    // ------------------- Victory -------------------
+    else if(currentState == STATE_VICTORY){
+        DrawTextureRectCounted(backgroundMenu, screenRect, WHITE);
+
+        // A tournament shows the standings over all rounds instead of one winner
+        if(arenaCount > 1){
+            DrawTextLayout(myFont, &standingsTitle, (Vector2){SCREEN_WIDTH/2 - standingsTitle.size.x/2, 150}, YELLOW);
+            for(int i=0;i<arenaCount*arenaTeams;i++) DrawTextLayout(myFont, &standingsTexts[i], (Vector2){80, 300 + i*50}, standingsColors[i]);
+        }else{
+            int winner = SimWinner(match);
+            const TextLayout *winnerText = &winnerTexts[winner >= 0 ? winner : SIM_MAX_TEAMS];
+            Color winnerColor = (winner >= 0) ? bindings.colors[winner] : YELLOW;
+            DrawTextLayout(myFont, winnerText, (Vector2){SCREEN_WIDTH/2 - winnerText->size.x/2, 150}, winnerColor);
+            for(int t=0;t<teamRecordRows;t++) DrawTextLayout(myFont, &teamRecordTexts[t], (Vector2){80, 300 + t*50}, bindings.colors[t]);
+        }
+        DrawLeaderboard();
+
+        float starWidth = SpriteSize(&atlas, SPRITE_STAR).x;
+        int startX = SCREEN_WIDTH/2 - (3 * (int)starWidth)/2;
+        for(int i=0;i<3;i++) DrawSprite(&atlas, SPRITE_STAR, startX + i*starWidth, 180, WHITE);
+
+        DrawMenuButtons(victoryMenuButtons);
+    }
+    RenderEnd();
+    return composed;
+}
+
+// Diagnostics at window resolution, so they stay readable at any render scale
+void DrawOverlays(){
+    RenderBeginOverlay();
+    if(showProfiler) ProfDrawOverlay(SCREEN_WIDTH - 510, 10);
+    if(showRenderStats){
+        int y = SCREEN_HEIGHT - 30;     // lines stack upwards
+        DrawText(TextFormat("draws: %d  texture switches: %d  text layouts: %d",
+            renderStats.drawCalls, renderStats.textureSwitches, textLayoutBuilds), 10, y, 20, LIME);
+        y -= 25;
+        DrawText(TextFormat("voices: %u played  %u stolen  %u dropped  music underruns: %u",
+            audioStats.played, audioStats.stolen, audioStats.dropped, MusicUnderruns()), 10, y, 20, LIME);
+        y -= 25;
+        if(networked){
+            const NetStats *st = &netClient.stats;
+            DrawText(TextFormat("team %d  rtt p50 %.0f ms p95 %.0f ms  snapshots %u (%u full)  rollbacks %u (%u ticks)",
+                netClient.team, NetRttPercentile(st, 0.5f), NetRttPercentile(st, 0.95f),
+                st->snapshots, st->fullSnapshots, st->rollbacks, st->resimulatedTicks), 10, y, 20, LIME);
+            y -= 25;
+        }
+        DrawText(TextFormat("render scale %.2f (%.2f-%.2f%s)  frame %.1f ms  changes %d", renderScaler.scale,
+            renderScaler.minScale, renderScaler.maxScale, renderScaler.automatic ? "" : ", fixed", renderScaler.frameMs, renderScaler.changes),
+            10, y, 20, LIME);
+        y -= 25;
+        if(TelemetryEnabled()){
+            TelemetryStats ts = TelemetryGetStats();
+            DrawText(TextFormat("telemetry: %llu events  %llu dropped  %llu lost  %d rotations", (unsigned long long)ts.pushed,
+                (unsigned long long)ts.dropped, (unsigned long long)ts.lost, ts.rotations), 10, y, 20, LIME);
+            y -= 25;
+        }
+        // GPU work tracks presents and composes; raylib has no GPU timers to read
+        DrawText(TextFormat("load: cpu %.1f%%  %.0f frames/s  %.0f composed/s%s", loadMeter.cpuPercent,
+            loadMeter.framesPerSec, loadMeter.composesPerSec, idleMode ? "  (idle)" : ""), 10, y, 20, LIME);
+    }
+    RenderEndOverlay();
+}
+// Once the menu group is uploaded: lay out text, set up the board
+void OnMenuAssetsReady() {
+    BuildTextCache();
+    BuildLeaderboard();
+    InitGame();
+    // Resume picks up the match that was running when the game last closed
+    if(!networked && !replaying && arenaCount == 1 && persistMatches && MatchLoadFile(match, RESUME_PATH)){
+        recordingValid = false;
+        TraceLog(LOG_INFO, "REPLAY: resumable match at %d s", (int)match->timer);
+    }
+}
+
+// Once the game group is uploaded: hammer sprites (for a split atlas) and the music
+void OnGameAssetsReady() {
+    if(!replaying){
+        Vector2 hammerSize = SpriteSize(&atlas, SPRITE_HAMMER_RED);
+        for(int k=0;k<arenaCount;k++) arenas[k].match.hammerSize = (SimVec2){hammerSize.x, hammerSize.y};
+    }
+    MusicStart("assets/audio/bgm.ogg", assetPack.base ? &assetPack : NULL, 0.3f);
+}
+
+// Wall clock, for cold-start reporting (GetTime() only starts at InitWindow)
+double WallSeconds(){
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+// Cold-start milestones. On the web the clock starts at navigation and the
+// byte count covers everything the page has downloaded so far (html, js, wasm,
+// preloaded data, background fetches that have finished).
+void LogMilestone(const char *what, double startTime){
+#if defined(PLATFORM_WEB)
+    (void)startTime;
+    double bytes = EM_ASM_DOUBLE({
+        let total = 0;
+        for(const e of performance.getEntriesByType('navigation').concat(performance.getEntriesByType('resource'))){
+            total += e.transferSize || e.encodedBodySize || 0;
+        }
+        return total;
+    });
+    TraceLog(LOG_INFO, "LOADER: %s after %.0f ms, %.0f KB downloaded", what, EM_ASM_DOUBLE({ return performance.now(); }), bytes/1024.0);
+#else
+    TraceLog(LOG_INFO, "LOADER: %s after %.0f ms", what, (WallSeconds() - startTime)*1000.0);
+#endif
+}
+
+// ------------------- Shutdown -------------------
+// Everything the game loaded or started; the window and audio device are the caller's
+void GameShutdown(){
+    SaveResume();
+    ReplayFree(&recording);
+    if(replaying){
+        ReplayPlayerFree(&viewer);
+        ReplayFree(&viewed);
+    }
+    LoaderShutdown();
+    ProfCloseCsv();
+    TelemetryClose();
+    HistoryClose();
+    ArenaPoolStop();
+    for(int k=0;k<ARENA_MAX;k++) SimFree(&arenas[k].match);
+    HitGridFree(&hitGrid);
+    if(networked) NetClientDisconnect(&netClient);
+    UnloadTexture(backgroundMenu);
+    UnloadTexture(backgroundGame);
+    UnloadAtlas(&atlas);
+    RenderShutdown();
+    UnloadEffects();
+
+    // Sounds: the music thread and the voice aliases go before what they read from
+    MusicStop();
+    SoundPool *soundPools[] = { &poolMolePop, &poolHitNormal, &poolHitGolden, &poolHitBomber, &poolHitEmpty, &poolButton, &poolVictory };
+    for(int i=0;i<(int)(sizeof(soundPools)/sizeof(soundPools[0]));i++) SoundPoolUnload(soundPools[i]);
+    UnloadSound(sndMolePop);
+    UnloadSound(sndHitNormal);
+    UnloadSound(sndHitGolden);
+    UnloadSound(sndHitBomber);
+    UnloadSound(sndHitEmpty);
+    UnloadSound(sndButton);
+    UnloadSound(sndVictory);
+
+    UnloadFont(myFont);
+    PackClose(&assetPack);
+}
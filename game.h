@@ -0,0 +1,76 @@
+#ifndef GAME_H
+#define GAME_H
+
+// The game: its state, assets, update and drawing. main.c reads the options and
+// runs the loop; tools/bench.c drives the same functions through scripted
+// scenarios.
+
+#include "raylib.h"
+#include "sim.h"
+#include "arena.h"
+#include "board.h"
+#include "input.h"
+#include "net.h"
+#include "replay.h"
+#include "textcache.h"
+
+// Virtual coordinates; the window and the render target can be any size (render.h)
+#define SCREEN_WIDTH 1920
+#define SCREEN_HEIGHT 1080
+
+// ------------------- Game States -------------------
+typedef enum { STATE_MENU, STATE_GAME, STATE_PAUSE, STATE_VICTORY } GameState;
+
+// ------------------- Menu Buttons -------------------
+typedef struct {
+    Rectangle rect;
+    const char *label;
+    bool isHovered;
+    bool isDisabled;
+    TextLayout text;    // label, laid out once
+} GameButton;
+
+// ------------------- State -------------------
+extern GameState currentState;
+extern Arena arenas[ARENA_MAX];
+extern int arenaCount, arenaTeams;
+extern Match *match;                // arena 0's
+extern bool lowLatency;
+extern NetClient netClient;
+extern bool networked;
+extern Replay viewed;
+extern ReplayPlayer viewer;
+extern bool replaying;
+extern bool persistMatches;         // resume snapshots and the last replay
+extern Bindings bindings;
+extern BoardLayout board;
+extern HitGrid hitGrid;
+extern GameButton mainMenuButtons[3], pauseMenuButtons[3], victoryMenuButtons[3];
+extern bool showRenderStats, showProfiler;
+extern bool idleMode;
+
+// ------------------- Setup -------------------
+void InitEffects(void);             // after InitWindow()
+void LoadAssets(void);              // queues everything on the background loader
+void OnMenuAssetsReady(void);
+void OnGameAssetsReady(void);
+void LayoutArenas(void);            // after arenaCount is final
+void InitGame(void);                // a new match (a new round in every arena)
+void GameShutdown(void);
+
+// ------------------- Frame -------------------
+void SetState(GameState state);
+void UpdateGameState(double now, Vector2 mousePos, bool *gamePaused);
+bool DrawGame(Vector2 mousePos);    // BeginDrawing() and the scene; false if a retained screen was reused
+void DrawOverlays(void);
+void DrawLoadingScreen(float progress);
+void DrainInputUntil(double deadline);
+void PaceFrame(double frameStart, double hz);
+bool CanIdle(void);
+void SetIdleMode(bool idle);
+void UpdateLoadMeter(bool composed);
+
+double WallSeconds(void);
+void LogMilestone(const char *what, double startTime);
+
+#endif
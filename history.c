@@ -0,0 +1,588 @@
+#if !defined(_WIN32)
+    #define _POSIX_C_SOURCE 200809L     // fileno, fsync, truncate under -std=c11
+#endif
+#include "history.h"
+#include "sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// No raylib here, so the platform headers can't clash with its names
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+    #include <fcntl.h>
+    #include <io.h>
+    #define HISTORY_MMAP 1
+#elif defined(__unix__) || defined(__APPLE__)
+    #include <unistd.h>
+    #if !defined(__EMSCRIPTEN__)
+        #include <fcntl.h>
+        #include <sys/mman.h>
+        #include <sys/stat.h>
+        #define HISTORY_MMAP 1
+    #endif
+#endif
+
+#if defined(PLATFORM_WEB)
+    #define HISTORY_THREADS 0
+#else
+    #define HISTORY_THREADS 1
+    #include <pthread.h>
+#endif
+
+// Index file (little-endian):
+//   IndexHeader | HistoryTeam[teamCount] by name | HistoryRecord[entries] best first
+#define INDEX_MAGIC "WAMH"
+#define INDEX_VERSION 1
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint64_t records;       // log records folded in: the tail starts here
+    uint64_t entries;       // records in the index (the log's, less any that failed their check)
+    uint32_t teamCount;
+    uint32_t matches;
+} IndexHeader;              // 32 bytes
+
+typedef struct {
+    const uint8_t *base;
+    size_t size;
+    bool mapped;            // memory-mapped (native) or read into memory (web)
+    void *handle;           // platform mapping handle
+} Mapping;
+
+#define WRITE_BATCH 256     // records per write and sync
+
+static struct {
+    bool open;
+    char logPath[256], indexPath[264], tmpPath[272];
+    FILE *log;                  // appends; the writer's
+    uint64_t logRecords;        // written and synced
+    uint32_t nextMatch;
+    bool failed;                // a write failed: nothing more is recorded
+    bool compactFailed;
+
+    Mapping index;              // replaced only by the writer, under the lock
+    const IndexHeader *header;  // NULL: no index yet
+    const HistoryTeam *teams;
+    const HistoryRecord *best;
+
+    HistoryRecord *tail;        // log records after the index, oldest first; the last queued aren't written yet
+    int tailCount, tailCapacity;
+    int queued;
+
+#if HISTORY_THREADS
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    bool quit;
+#endif
+} hist;
+
+#if HISTORY_THREADS
+static void Lock(void){ pthread_mutex_lock(&hist.lock); }
+static void Unlock(void){ pthread_mutex_unlock(&hist.lock); }
+#else
+static void Lock(void){}
+static void Unlock(void){}
+#endif
+
+// ------------------- Records -------------------
+static uint32_t RecordCheck(const HistoryRecord *r){
+    return (uint32_t)SimHash((const uint8_t *)r + sizeof(r->check), sizeof(*r) - sizeof(r->check));
+}
+
+// Best score first, then the older match
+static int CompareBest(const void *a, const void *b){
+    const HistoryRecord *x = a, *y = b;
+    if(x->score != y->score) return (x->score > y->score) ? -1 : 1;
+    return (x->match > y->match) - (x->match < y->match);
+}
+
+static int CompareTeams(const void *a, const void *b){
+    return memcmp(((const HistoryTeam *)a)->team, ((const HistoryTeam *)b)->team, HISTORY_NAME_MAX);
+}
+
+static void AddRecord(HistoryTeam *t, const HistoryRecord *r){
+    if(t->matches == 0 || r->score > t->best) t->best = r->score;
+    t->matches++;
+    t->wins += r->won;
+    t->points += r->score;
+}
+
+static void AddTeam(HistoryTeam *into, const HistoryTeam *t){
+    if(into->matches == 0 || t->best > into->best) into->best = t->best;
+    into->matches += t->matches;
+    into->wins += t->wins;
+    into->points += t->points;
+}
+
+static bool ReserveTail(int extra){
+    if(hist.tailCount + extra <= hist.tailCapacity) return true;
+    int capacity = hist.tailCapacity ? hist.tailCapacity : 1024;
+    while(capacity < hist.tailCount + extra) capacity *= 2;
+    HistoryRecord *grown = realloc(hist.tail, (size_t)capacity*sizeof(HistoryRecord));
+    if(!grown) return false;
+    hist.tail = grown;
+    hist.tailCapacity = capacity;
+    return true;
+}
+
+// ------------------- Files -------------------
+static bool SyncFile(FILE *f){
+    if(fflush(f) != 0) return false;
+#if defined(_WIN32)
+    return _commit(_fileno(f)) == 0;
+#elif defined(__EMSCRIPTEN__)
+    return true;
+#else
+    return fsync(fileno(f)) == 0;
+#endif
+}
+
+static bool TruncateFile(const char *path, long size){
+#if defined(_WIN32)
+    int fd = _open(path, _O_RDWR | _O_BINARY);
+    if(fd < 0) return false;
+    bool ok = _chsize_s(fd, size) == 0;
+    _close(fd);
+    return ok;
+#else
+    return truncate(path, size) == 0;
+#endif
+}
+
+#if defined(HISTORY_MMAP) && defined(_WIN32)
+static bool MapFile(Mapping *m, const char *path){
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    HANDLE mapping = NULL;
+    if(GetFileSizeEx(file, &size) && size.QuadPart > 0) mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if(!mapping) return false;
+    m->base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if(!m->base){ CloseHandle(mapping); return false; }
+    m->size = (size_t)size.QuadPart;
+    m->handle = mapping;
+    m->mapped = true;
+    return true;
+}
+
+static void UnmapFile(Mapping *m){
+    UnmapViewOfFile(m->base);
+    CloseHandle(m->handle);
+}
+#elif defined(HISTORY_MMAP)
+static bool MapFile(Mapping *m, const char *path){
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) return false;
+    struct stat st;
+    void *base = MAP_FAILED;
+    if(fstat(fd, &st) == 0 && st.st_size > 0) base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(base == MAP_FAILED) return false;
+    m->base = base;
+    m->size = (size_t)st.st_size;
+    m->mapped = true;
+    return true;
+}
+
+static void UnmapFile(Mapping *m){
+    munmap((void *)m->base, m->size);
+}
+#endif
+
+// Fallback (web): read it all in
+static bool ReadWholeFile(Mapping *m, const char *path){
+    FILE *f = fopen(path, "rb");
+    if(!f) return false;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *data = (size > 0) ? malloc((size_t)size) : NULL;
+    bool ok = data && fread(data, 1, (size_t)size, f) == (size_t)size;
+    fclose(f);
+    if(!ok){ free(data); return false; }
+    m->base = data;
+    m->size = (size_t)size;
+    m->mapped = false;
+    return true;
+}
+
+static void CloseIndex(void){
+    if(hist.index.base){
+#if defined(HISTORY_MMAP)
+        if(hist.index.mapped) UnmapFile(&hist.index);
+        else free((void *)hist.index.base);
+#else
+        free((void *)hist.index.base);
+#endif
+    }
+    memset(&hist.index, 0, sizeof(hist.index));
+    hist.header = NULL;
+    hist.teams = NULL;
+    hist.best = NULL;
+}
+
+// Maps F.idx if it's whole and covers no more of the log than there is
+static bool OpenIndex(void){
+    bool ok = false;
+#if defined(HISTORY_MMAP)
+    ok = MapFile(&hist.index, hist.indexPath);
+#endif
+    if(!ok) ok = ReadWholeFile(&hist.index, hist.indexPath);
+    if(!ok) return false;
+
+    const IndexHeader *h = (const IndexHeader *)hist.index.base;
+    bool valid = hist.index.size >= sizeof(IndexHeader) && memcmp(h->magic, INDEX_MAGIC, 4) == 0
+              && h->version == INDEX_VERSION && h->records <= hist.logRecords && h->entries <= h->records
+              && hist.index.size == sizeof(IndexHeader) + h->teamCount*sizeof(HistoryTeam) + h->entries*sizeof(HistoryRecord);
+    if(!valid){
+        CloseIndex();
+        return false;
+    }
+    hist.header = h;
+    hist.teams = (const HistoryTeam *)(hist.index.base + sizeof(IndexHeader));
+    hist.best = (const HistoryRecord *)(hist.teams + h->teamCount);
+    return true;
+}
+
+// ------------------- Writer -------------------
+// Both run with the lock held and drop it for the file work
+
+static void WriteQueued(void){
+    static HistoryRecord batch[WRITE_BATCH];
+    int count = hist.queued < WRITE_BATCH ? hist.queued : WRITE_BATCH;
+    memcpy(batch, hist.tail + hist.tailCount - hist.queued, (size_t)count*sizeof(HistoryRecord));
+    Unlock();
+    bool ok = fwrite(batch, sizeof(HistoryRecord), (size_t)count, hist.log) == (size_t)count && SyncFile(hist.log);
+    Lock();
+    if(ok){
+        hist.queued -= count;
+        hist.logRecords += count;
+        return;
+    }
+    // Queries would otherwise count matches the log doesn't have; a partial write is cut off at the next open
+    fprintf(stderr, "HISTORY: cannot write %s, not recording any more matches\n", hist.logPath);
+    hist.tailCount -= hist.queued;
+    hist.queued = 0;
+    hist.failed = true;
+}
+
+static bool NeedsCompaction(void){
+    int written = hist.tailCount - hist.queued;
+    return !hist.compactFailed && written > 0 && (written >= HISTORY_COMPACT_RECORDS || !hist.header);
+}
+
+// The current index merged with the folded records (sorted here) into F.idx.tmp.
+// Only the writer replaces the index, so it can read it without the lock.
+static bool WriteIndex(HistoryRecord *folded, int count, uint64_t records){
+    qsort(folded, count, sizeof(HistoryRecord), CompareBest);
+
+    // Totals of the folded records by team, then merged with the index's
+    HistoryTeam *added = calloc((size_t)count, sizeof(HistoryTeam));
+    uint32_t oldTeams = hist.header ? hist.header->teamCount : 0;
+    HistoryTeam *teams = malloc(((size_t)oldTeams + count)*sizeof(HistoryTeam));
+    if(!added || !teams){ free(added); free(teams); return false; }
+    uint32_t matches = hist.header ? hist.header->matches : 0;
+    for(int i=0;i<count;i++){
+        memcpy(added[i].team, folded[i].team, HISTORY_NAME_MAX);
+        AddRecord(&added[i], &folded[i]);
+        matches += folded[i].last;
+    }
+    qsort(added, count, sizeof(HistoryTeam), CompareTeams);
+    int addedCount = 0;
+    for(int i=0;i<count;i++){
+        if(addedCount > 0 && CompareTeams(&added[addedCount-1], &added[i]) == 0) AddTeam(&added[addedCount-1], &added[i]);
+        else added[addedCount++] = added[i];
+    }
+    uint32_t teamCount = 0, a = 0;
+    int b = 0;
+    while(a < oldTeams || b < addedCount){
+        int c = (a == oldTeams) ? 1 : (b == addedCount) ? -1 : CompareTeams(&hist.teams[a], &added[b]);
+        if(c < 0) teams[teamCount++] = hist.teams[a++];
+        else if(c > 0) teams[teamCount++] = added[b++];
+        else{
+            teams[teamCount] = hist.teams[a++];
+            AddTeam(&teams[teamCount++], &added[b++]);
+        }
+    }
+    free(added);
+
+    FILE *f = fopen(hist.tmpPath, "wb");
+    if(!f){ free(teams); return false; }
+    uint64_t oldEntries = hist.header ? hist.header->entries : 0;
+    IndexHeader h = { INDEX_MAGIC, INDEX_VERSION, records, oldEntries + count, teamCount, matches };
+    bool ok = fwrite(&h, sizeof(h), 1, f) == 1 && fwrite(teams, sizeof(HistoryTeam), teamCount, f) == teamCount;
+    free(teams);
+
+    // Best records: two sorted runs, streamed out
+    uint64_t i = 0;
+    int j = 0;
+    while(ok && (i < oldEntries || j < count)){
+        const HistoryRecord *r = (j == count || (i < oldEntries && CompareBest(&hist.best[i], &folded[j]) <= 0))
+                               ? &hist.best[i++] : &folded[j++];
+        ok = fwrite(r, sizeof(*r), 1, f) == 1;
+    }
+    ok = SyncFile(f) && ok;
+    ok = (fclose(f) == 0) && ok;
+    if(!ok) remove(hist.tmpPath);
+    return ok;
+}
+
+static void Compact(void){
+    int count = hist.tailCount - hist.queued;
+    uint64_t records = hist.logRecords;
+    HistoryRecord *folded = malloc((size_t)count*sizeof(HistoryRecord));
+    if(folded) memcpy(folded, hist.tail, (size_t)count*sizeof(HistoryRecord));
+    Unlock();
+    bool ok = folded && WriteIndex(folded, count, records);
+    free(folded);
+    Lock();
+
+    // Swapped with the lock held, so queries see the old index and tail or the new ones
+    if(ok){
+        CloseIndex();
+#if defined(_WIN32)
+        remove(hist.indexPath);     // rename() won't replace a file here
+#endif
+        ok = rename(hist.tmpPath, hist.indexPath) == 0 && OpenIndex();
+    }
+    if(ok){
+        memmove(hist.tail, hist.tail + count, (size_t)(hist.tailCount - count)*sizeof(HistoryRecord));
+        hist.tailCount -= count;
+        return;
+    }
+    fprintf(stderr, "HISTORY: cannot write %s, queries will read the whole tail\n", hist.indexPath);
+    hist.compactFailed = true;
+    if(!hist.header) OpenIndex();   // whatever was there before
+}
+
+#if HISTORY_THREADS
+static void *WriterThread(void *arg){
+    (void)arg;
+    Lock();
+    for(;;){
+        if(hist.queued > 0) WriteQueued();
+        else if(NeedsCompaction()) Compact();
+        else if(hist.quit) break;
+        else pthread_cond_wait(&hist.wake, &hist.lock);
+    }
+    Unlock();
+    return NULL;
+}
+#endif
+
+// ------------------- Open/Close -------------------
+bool HistoryOpen(const char *path){
+    if(hist.open) return true;
+    snprintf(hist.logPath, sizeof(hist.logPath), "%s", path);
+    snprintf(hist.indexPath, sizeof(hist.indexPath), "%s.idx", path);
+    snprintf(hist.tmpPath, sizeof(hist.tmpPath), "%s.idx.tmp", path);
+
+    // Cut the log back to its last whole match
+    long records = 0, size = 0;
+    HistoryRecord r;
+    FILE *f = fopen(path, "rb");
+    if(f){
+        fseek(f, 0, SEEK_END);
+        size = ftell(f);
+        records = size/(long)sizeof(HistoryRecord);
+        for(;records > 0;records--){
+            fseek(f, (records - 1)*(long)sizeof(HistoryRecord), SEEK_SET);
+            if(fread(&r, sizeof(r), 1, f) == 1 && r.check == RecordCheck(&r) && r.last) break;
+        }
+        fclose(f);
+    }
+    if(records*(long)sizeof(HistoryRecord) != size){
+        if(!TruncateFile(path, records*(long)sizeof(HistoryRecord))){
+            fprintf(stderr, "HISTORY: cannot repair %s\n", path);
+            return false;
+        }
+        fprintf(stderr, "HISTORY: dropped %ld bytes of an unfinished write from %s\n", size - records*(long)sizeof(HistoryRecord), path);
+    }
+    hist.logRecords = (uint64_t)records;
+    hist.nextMatch = (records > 0) ? r.match + 1 : 1;
+
+    // The index, and whatever the log has past it
+    if(!OpenIndex() && records > 0) fprintf(stderr, "HISTORY: rebuilding the index of %s\n", path);
+    uint64_t covered = hist.header ? hist.header->records : 0;
+    hist.tailCount = hist.queued = 0;
+    int skipped = 0;
+    f = (hist.logRecords > covered) ? fopen(path, "rb") : NULL;
+    if(f){
+        fseek(f, (long)covered*(long)sizeof(HistoryRecord), SEEK_SET);
+        for(uint64_t at=covered;at<hist.logRecords && ReserveTail(1);at++){
+            if(fread(&r, sizeof(r), 1, f) != 1) break;
+            if(r.check == RecordCheck(&r)) hist.tail[hist.tailCount++] = r;
+            else skipped++;
+        }
+        fclose(f);
+    }
+    if(skipped > 0) fprintf(stderr, "HISTORY: skipped %d damaged records in %s\n", skipped, path);
+
+    hist.log = fopen(path, "ab");
+    if(!hist.log){
+        fprintf(stderr, "HISTORY: cannot open %s\n", path);
+        CloseIndex();
+        return false;
+    }
+    hist.failed = hist.compactFailed = false;
+#if HISTORY_THREADS
+    pthread_mutex_init(&hist.lock, NULL);
+    pthread_cond_init(&hist.wake, NULL);
+    hist.quit = false;
+    if(pthread_create(&hist.thread, NULL, WriterThread, NULL) != 0){
+        pthread_cond_destroy(&hist.wake);
+        pthread_mutex_destroy(&hist.lock);
+        fclose(hist.log);
+        CloseIndex();
+        fprintf(stderr, "HISTORY: cannot start the writer thread\n");
+        return false;
+    }
+#else
+    if(NeedsCompaction()) Compact();
+#endif
+    hist.open = true;
+    fprintf(stderr, "HISTORY: %s, %u matches (%d records past the index)\n", path, HistoryMatchCount(), hist.tailCount);
+    return true;
+}
+
+void HistoryClose(void){
+    if(!hist.open) return;
+#if HISTORY_THREADS
+    Lock();
+    hist.quit = true;
+    pthread_cond_signal(&hist.wake);
+    Unlock();
+    pthread_join(hist.thread, NULL);
+    pthread_cond_destroy(&hist.wake);
+    pthread_mutex_destroy(&hist.lock);
+#endif
+    hist.open = false;
+    fclose(hist.log);
+    hist.log = NULL;
+    CloseIndex();
+    free(hist.tail);
+    hist.tail = NULL;
+    hist.tailCount = hist.tailCapacity = hist.queued = 0;
+}
+
+bool HistoryEnabled(void){
+    return hist.open;
+}
+
+// ------------------- Recording -------------------
+void HistoryAddMatch(int teamCount, const char *const names[], const int scores[], int winner){
+    if(!hist.open || teamCount < 1) return;
+    if(teamCount > SIM_MAX_TEAMS) teamCount = SIM_MAX_TEAMS;
+    int64_t now = (int64_t)time(NULL);
+    Lock();
+    if(!hist.failed && ReserveTail(teamCount)){
+        for(int t=0;t<teamCount;t++){
+            HistoryRecord *r = &hist.tail[hist.tailCount++];
+            memset(r, 0, sizeof(*r));
+            r->match = hist.nextMatch;
+            r->time = now;
+            snprintf(r->team, HISTORY_NAME_MAX, "%s", names[t]);
+            r->score = scores[t];
+            r->won = (t == winner);
+            r->teamCount = (uint8_t)teamCount;
+            r->last = (t == teamCount - 1);
+            r->check = RecordCheck(r);
+        }
+        hist.nextMatch++;
+        hist.queued += teamCount;
+#if HISTORY_THREADS
+        pthread_cond_signal(&hist.wake);
+#else
+        while(hist.queued > 0) WriteQueued();
+        if(NeedsCompaction()) Compact();
+#endif
+    }
+    Unlock();
+}
+
+// ------------------- Queries -------------------
+// Keeps top[] the best *count (up to max) seen, best first
+static void InsertTop(HistoryRecord *top, int *count, int max, const HistoryRecord *r){
+    if(*count == max && CompareBest(r, &top[max-1]) >= 0) return;
+    int i = (*count < max) ? (*count)++ : max - 1;
+    for(;i > 0 && CompareBest(r, &top[i-1]) < 0;i--) top[i] = top[i-1];
+    top[i] = *r;
+}
+
+int HistoryTopScores(HistoryRecord *out, int max){
+    if(!hist.open || max <= 0) return 0;
+    HistoryRecord *top = malloc((size_t)max*sizeof(HistoryRecord));
+    if(!top) return 0;
+    int count = 0, topCount = 0;
+    Lock();
+    // The index is already in order; the tail's best few are merged in
+    for(int i=0;i<hist.tailCount;i++) InsertTop(top, &topCount, max, &hist.tail[i]);
+    uint64_t entries = hist.header ? hist.header->entries : 0, i = 0;
+    int j = 0;
+    while(count < max && (i < entries || j < topCount)){
+        if(j == topCount || (i < entries && CompareBest(&hist.best[i], &top[j]) <= 0)) out[count++] = hist.best[i++];
+        else out[count++] = top[j++];
+    }
+    Unlock();
+    free(top);
+    return count;
+}
+
+int HistoryRecent(HistoryRecord *out, int max){
+    if(!hist.open || max <= 0) return 0;
+    int count = 0;
+    Lock();
+    for(int i=hist.tailCount-1;i>=0 && count<max;i--) out[count++] = hist.tail[i];
+    uint64_t before = hist.header ? hist.header->records : 0;
+    Unlock();
+
+    // Older ones from the end of the log's indexed part, which never changes
+    int more = (max - count < (int64_t)before) ? max - count : (int)before;
+    FILE *f = (more > 0) ? fopen(hist.logPath, "rb") : NULL;
+    if(f){
+        fseek(f, (long)(before - more)*(long)sizeof(HistoryRecord), SEEK_SET);
+        int got = (int)fread(out + count, sizeof(HistoryRecord), (size_t)more, f);
+        fclose(f);
+        for(int a=count, b=count+got-1;a<b;a++, b--){
+            HistoryRecord swap = out[a]; out[a] = out[b]; out[b] = swap;
+        }
+        count += got;
+    }
+    return count;
+}
+
+bool HistoryTeamStats(const char *team, HistoryTeam *out){
+    memset(out, 0, sizeof(*out));
+    snprintf(out->team, HISTORY_NAME_MAX, "%s", team);
+    if(!hist.open) return false;
+    Lock();
+    if(hist.header){
+        uint32_t lo = 0, hi = hist.header->teamCount;
+        while(lo < hi){
+            uint32_t mid = lo + (hi - lo)/2;
+            if(CompareTeams(&hist.teams[mid], out) < 0) lo = mid + 1;
+            else hi = mid;
+        }
+        if(lo < hist.header->teamCount && CompareTeams(&hist.teams[lo], out) == 0) *out = hist.teams[lo];
+    }
+    for(int i=0;i<hist.tailCount;i++){
+        if(memcmp(hist.tail[i].team, out->team, HISTORY_NAME_MAX) == 0) AddRecord(out, &hist.tail[i]);
+    }
+    Unlock();
+    return out->matches > 0;
+}
+
+uint32_t HistoryMatchCount(void){
+    if(!hist.open) return 0;
+    Lock();
+    uint32_t matches = hist.header ? hist.header->matches : 0;
+    for(int i=0;i<hist.tailCount;i++) matches += hist.tail[i].last;
+    Unlock();
+    return matches;
+}
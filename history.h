@@ -0,0 +1,61 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+// Match history. Every finished match appends one fixed-size record per team to
+// a log (F, e.g. history.log); the log is only ever appended to, and each match's
+// records go out in one write followed by a sync. Opening drops a torn tail (a
+// record failing its check, or a match without its last record), so a crash
+// loses at most the match being written.
+//
+// Queries never read the whole log. An index (F.idx) holds the per-team totals
+// sorted by name and every record sorted best score first; it is memory-mapped
+// and covers the log up to some record. Records after that (the tail) are kept
+// in memory and merged into query results. Once the tail reaches
+// HISTORY_COMPACT_RECORDS the writer folds it into a new index, merging the two
+// sorted inputs (the log isn't read), writes it aside and renames it into place.
+// A missing or stale index is rebuilt from the log the same way.
+//
+// Writes and compaction happen on a background thread; the game thread only
+// copies a match into the tail. Builds without threads (PLATFORM_WEB) do both
+// in HistoryAddMatch. No raylib here.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define HISTORY_NAME_MAX 16             // team name, NUL-padded
+#define HISTORY_COMPACT_RECORDS 4096    // tail records that trigger a compaction
+
+typedef struct {
+    uint32_t check;                 // hash of the rest of the record
+    uint32_t match;                 // match number; a match's records are adjacent
+    int64_t time;                   // unix seconds, when it ended
+    char team[HISTORY_NAME_MAX];    // bindings name
+    int32_t score;
+    uint8_t won;                    // nobody wins a draw
+    uint8_t teamCount;
+    uint8_t last;                   // the match's final record
+    uint8_t pad;
+} HistoryRecord;                    // 40 bytes
+
+typedef struct {
+    char team[HISTORY_NAME_MAX];
+    uint32_t matches, wins;
+    int32_t best;
+    uint32_t pad;
+    int64_t points;
+} HistoryTeam;                      // 40 bytes
+
+bool HistoryOpen(const char *path);
+void HistoryClose(void);            // writes what's queued, folds a full tail, then joins the writer
+bool HistoryEnabled(void);
+
+// Game thread: one finished match; winner -1 for a draw
+void HistoryAddMatch(int teamCount, const char *const names[], const int scores[], int winner);
+
+// Queries, from any thread; each returns what it found
+int HistoryTopScores(HistoryRecord *out, int max);          // best first; ties oldest first
+int HistoryRecent(HistoryRecord *out, int max);             // newest first
+bool HistoryTeamStats(const char *team, HistoryTeam *out);  // false if it never played
+uint32_t HistoryMatchCount(void);
+
+#endif
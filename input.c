@@ -0,0 +1,235 @@
+#include "input.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_KEYS 512
+#define LATENCY_WINDOW 64   // samples per logged summary
+
+// ------------------- Event Queue -------------------
+static InputEvent queue[INPUT_QUEUE_SIZE];
+static int queueHead = 0, queueCount = 0;
+
+void InputPush(InputEvent event){
+    if(queueCount == INPUT_QUEUE_SIZE){
+        TraceLog(LOG_WARNING, "INPUT: event queue full, dropping a hit");
+        return;
+    }
+    queue[(queueHead + queueCount++) % INPUT_QUEUE_SIZE] = event;
+}
+
+bool InputPop(InputEvent *event){
+    if(queueCount == 0) return false;
+    *event = queue[queueHead];
+    queueHead = (queueHead + 1) % INPUT_QUEUE_SIZE;
+    queueCount--;
+    return true;
+}
+
+// ------------------- Bindings -------------------
+typedef struct { const char *name; int key; } KeyName;
+
+static const KeyName keyNames[] = {
+    {"SPACE", KEY_SPACE}, {"ENTER", KEY_ENTER}, {"TAB", KEY_TAB}, {"BACKSPACE", KEY_BACKSPACE},
+    {"UP", KEY_UP}, {"DOWN", KEY_DOWN}, {"LEFT", KEY_LEFT}, {"RIGHT", KEY_RIGHT},
+    {"INSERT", KEY_INSERT}, {"DELETE", KEY_DELETE}, {"HOME", KEY_HOME}, {"END", KEY_END},
+    {"PAGE_UP", KEY_PAGE_UP}, {"PAGE_DOWN", KEY_PAGE_DOWN},
+    {"KP_DECIMAL", KEY_KP_DECIMAL}, {"KP_DIVIDE", KEY_KP_DIVIDE}, {"KP_MULTIPLY", KEY_KP_MULTIPLY},
+    {"KP_SUBTRACT", KEY_KP_SUBTRACT}, {"KP_ADD", KEY_KP_ADD}, {"KP_ENTER", KEY_KP_ENTER},
+    {"LEFT_SHIFT", KEY_LEFT_SHIFT}, {"RIGHT_SHIFT", KEY_RIGHT_SHIFT},
+    {"LEFT_CONTROL", KEY_LEFT_CONTROL}, {"RIGHT_CONTROL", KEY_RIGHT_CONTROL},
+};
+
+// Letters, digits and punctuation are their ASCII code in raylib; the rest are named
+static int ParseKey(const char *name){
+    if(strlen(name) == 1){
+        char c = (char)toupper((unsigned char)name[0]);
+        if(strchr("ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789',-./;=[\\]`", c)) return c;
+        return KEY_NULL;
+    }
+    if(name[0] == 'F' && isdigit((unsigned char)name[1])){
+        int n = atoi(name + 1);
+        return (n >= 1 && n <= 12) ? KEY_F1 + n - 1 : KEY_NULL;
+    }
+    if(strncmp(name, "KP_", 3) == 0 && isdigit((unsigned char)name[3]) && name[4] == 0) return KEY_KP_0 + (name[3] - '0');
+    for(size_t i=0;i<sizeof(keyNames)/sizeof(keyNames[0]);i++){
+        if(strcmp(name, keyNames[i].name) == 0) return keyNames[i].key;
+    }
+    return KEY_NULL;
+}
+
+static void AddTeam(Bindings *b, const char *name, Color color, const char *const keys[], int keyCount){
+    int t = b->teamCount++;
+    snprintf(b->names[t], sizeof(b->names[t]), "%s", name);
+    b->colors[t] = color;
+    b->keyCount[t] = keyCount;
+    for(int i=0;i<keyCount;i++){
+        b->keys[t][i] = ParseKey(keys[i]);
+        snprintf(b->keyNames[t][i], sizeof(b->keyNames[t][i]), "%s", b->keys[t][i] ? keys[i] : "");
+    }
+}
+
+void BindingsDefault(Bindings *bindings){
+    static const char *const redKeys[] = { "S", "E", "Z", "R", "G" };
+    static const char *const blueKeys[] = { "H", "U", "B", "I", "L" };
+    memset(bindings, 0, sizeof(*bindings));
+    AddTeam(bindings, "Red", RED, redKeys, 5);
+    AddTeam(bindings, "Blue", BLUE, blueKeys, 5);
+}
+
+bool BindingsLoad(Bindings *bindings, const char *path){
+    FILE *f = fopen(path, "r");
+    if(!f) return false;
+    memset(bindings, 0, sizeof(*bindings));
+
+    bool used[MAX_KEYS] = {0};
+    char line[512];
+    int lineNo = 0;
+    bool ok = true;
+    while(ok && fgets(line, sizeof(line), f)){
+        lineNo++;
+        char *tok = strtok(line, " \t\r\n");
+        if(!tok || tok[0] == '#') continue;
+
+        char *name = strtok(NULL, " \t\r\n");
+        char *color = strtok(NULL, " \t\r\n");
+        unsigned int rgb;
+        if(strcmp(tok, "team") != 0 || !name || !color || color[0] != '#' || sscanf(color + 1, "%6x", &rgb) != 1){
+            TraceLog(LOG_WARNING, "INPUT: %s:%d: expected 'team <name> #RRGGBB <keys...>'", path, lineNo);
+            ok = false;
+            break;
+        }
+        if(bindings->teamCount == SIM_MAX_TEAMS){
+            TraceLog(LOG_WARNING, "INPUT: %s: more than %d teams", path, SIM_MAX_TEAMS);
+            ok = false;
+            break;
+        }
+
+        const char *keys[BINDINGS_MAX_KEYS];
+        int keyCount = 0;
+        char *k;
+        while((k = strtok(NULL, " \t\r\n")) && keyCount < BINDINGS_MAX_KEYS){
+            int key = (strcmp(k, "-") == 0) ? KEY_NULL : ParseKey(k);
+            if(strcmp(k, "-") != 0 && (key == KEY_NULL || used[key])){
+                TraceLog(LOG_WARNING, "INPUT: %s:%d: %s key '%s'", path, lineNo, key ? "duplicate" : "unknown", k);
+                ok = false;
+                break;
+            }
+            used[key] = true;
+            keys[keyCount++] = k;
+        }
+        Color c = { (rgb >> 16) & 0xFF, (rgb >> 8) & 0xFF, rgb & 0xFF, 255 };
+        if(ok) AddTeam(bindings, name, c, keys, keyCount);
+    }
+    fclose(f);
+
+    if(ok && bindings->teamCount == 0){
+        TraceLog(LOG_WARNING, "INPUT: %s defines no teams", path);
+        ok = false;
+    }
+    if(ok) TraceLog(LOG_INFO, "INPUT: %d teams bound from %s", bindings->teamCount, path);
+    return ok;
+}
+
+// ------------------- Dispatch -------------------
+static int8_t keyTeam[MAX_KEYS];      // -1 = not a hit key
+static int16_t keyHole[MAX_KEYS];
+static const HitGrid *hitGrid = NULL;
+
+static bool pressedKeys[MAX_KEYS];
+static int pressedList[MAX_KEYS];
+static int pressedCount = 0;
+static bool mousePressed = false;
+
+void InputSetBindings(const Bindings *bindings){
+    memset(keyTeam, -1, sizeof(keyTeam));
+    for(int t=0;t<bindings->teamCount;t++){
+        for(int i=0;i<bindings->keyCount[t];i++){
+            int key = bindings->keys[t][i];
+            if(key <= 0 || key >= MAX_KEYS) continue;
+            keyTeam[key] = (int8_t)t;
+            keyHole[key] = (int16_t)i;
+        }
+    }
+}
+
+void InputSetHitGrid(const HitGrid *grid){
+    hitGrid = grid;
+}
+
+void InputFrameClear(void){
+    for(int i=0;i<pressedCount;i++) pressedKeys[pressedList[i]] = false;
+    pressedCount = 0;
+    mousePressed = false;
+}
+
+void InputDrain(double now, bool inGame){
+    int key;
+    while((key = GetKeyPressed()) != 0){
+        if(key <= 0 || key >= MAX_KEYS) continue;
+        if(!pressedKeys[key]){
+            pressedKeys[key] = true;
+            pressedList[pressedCount++] = key;
+        }
+        if(inGame && keyTeam[key] >= 0) InputPush((InputEvent){ now, keyHole[key], keyTeam[key] });
+    }
+    while(GetCharPressed() != 0){}      // unused, but raylib only resets it on the next poll
+
+    if(IsMouseButtonPressed(MOUSE_BUTTON_LEFT)){
+        mousePressed = true;
+        if(inGame && hitGrid){
+            Vector2 pos = GetMousePosition();
+            int team;
+            int hole = HitGridQuery(hitGrid, pos.x, pos.y, &team);
+            if(hole >= 0) InputPush((InputEvent){ now, hole, team });
+        }
+    }
+}
+
+bool InputKeyPressed(int key){
+    return key > 0 && key < MAX_KEYS && pressedKeys[key];
+}
+
+bool InputMousePressed(void){
+    return mousePressed;
+}
+
+// ------------------- Latency Probe -------------------
+typedef struct {
+    const char *name;
+    float samples[LATENCY_WINDOW];
+    int count;
+} LatencySeries;
+
+static LatencySeries hitLatency = { "press->hit" };
+static LatencySeries presentLatency = { "press->present" };
+
+// Presses applied since the last present
+static double awaitingPresent[INPUT_QUEUE_SIZE];
+static int awaitingCount = 0;
+
+static int CompareFloat(const void *a, const void *b){
+    float x = *(const float *)a, y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+static void AddSample(LatencySeries *series, float ms){
+    series->samples[series->count++] = ms;
+    if(series->count < LATENCY_WINDOW) return;
+
+    qsort(series->samples, LATENCY_WINDOW, sizeof(float), CompareFloat);
+    TraceLog(LOG_INFO, "LATENCY: %s p50 %.2f ms  p95 %.2f ms  max %.2f ms (%d presses)", series->name,
+        series->samples[LATENCY_WINDOW/2], series->samples[LATENCY_WINDOW*95/100], series->samples[LATENCY_WINDOW-1], LATENCY_WINDOW);
+    series->count = 0;
+}
+
+void LatencyOnHit(double pressTime, double now){
+    AddSample(&hitLatency, (float)((now - pressTime)*1000.0));
+    if(awaitingCount < INPUT_QUEUE_SIZE) awaitingPresent[awaitingCount++] = pressTime;
+}
+
+void LatencyOnPresent(double now){
+    for(int i=0;i<awaitingCount;i++) AddSample(&presentLatency, (float)((now - awaitingPresent[i])*1000.0));
+    awaitingCount = 0;
+}
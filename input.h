@@ -0,0 +1,54 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+// Input dispatch. InputDrain() empties raylib's key queue once per frame (and
+// after every extra poll in low-latency mode): each key maps through a table to
+// a (team, hole) hit and is also remembered as pressed for the menus. A click
+// goes through one hit-grid lookup on the board. Hits are queued with the time
+// they were seen and applied to the simulation at that time.
+
+#include "raylib.h"
+#include "sim.h"
+#include "board.h"
+
+#define INPUT_QUEUE_SIZE 64
+#define BINDINGS_MAX_KEYS 32    // keyed holes per team; any further holes are mouse/touch only
+
+typedef struct {
+    double time;    // GetTime() of the poll that saw the press
+    int hole;
+    int team;
+} InputEvent;
+
+// ------------------- Bindings -------------------
+// Config file, one line per team (up to SIM_MAX_TEAMS), keys in hole order:
+//   team Red  #E62937  S E Z R G        ("-" leaves a hole unbound)
+typedef struct {
+    int teamCount;
+    char names[SIM_MAX_TEAMS][16];
+    Color colors[SIM_MAX_TEAMS];
+    int keyCount[SIM_MAX_TEAMS];
+    int keys[SIM_MAX_TEAMS][BINDINGS_MAX_KEYS];             // KEY_NULL = unbound
+    char keyNames[SIM_MAX_TEAMS][BINDINGS_MAX_KEYS][16];    // as written in the config (RIGHT_CONTROL is the longest)
+} Bindings;
+
+void BindingsDefault(Bindings *bindings);               // Red S E Z R G, Blue H U B I L
+bool BindingsLoad(Bindings *bindings, const char *path);
+void InputSetBindings(const Bindings *bindings);        // builds the key -> (team, hole) table
+void InputSetHitGrid(const HitGrid *grid);              // board buttons for clicks
+
+// ------------------- Dispatch -------------------
+void InputFrameClear(void);                 // once per frame, before the first drain
+void InputDrain(double now, bool inGame);   // after every PollInputEvents(); hits are only queued inGame
+bool InputKeyPressed(int key);              // drained since the last clear
+bool InputMousePressed(void);               // left button, same rule
+
+void InputPush(InputEvent event);
+bool InputPop(InputEvent *event);
+
+// ------------------- Latency Probe -------------------
+// Press -> SimHit and press -> present, logged as rolling percentiles
+void LatencyOnHit(double pressTime, double now);
+void LatencyOnPresent(double now);
+
+#endif
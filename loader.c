@@ -0,0 +1,376 @@
+#include "loader.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(PLATFORM_WEB)
+    #define LOADER_THREADS 0    // no shared-memory threads in the default web build: decode inline
+    #include <emscripten.h>
+    #include <sys/stat.h>
+#else
+    #define LOADER_THREADS 1
+    #include <pthread.h>
+#endif
+
+#define LOADER_MAX_THREADS 4
+#define FONT_SIZE 32            // what LoadFont() uses for TTF
+#define FONT_GLYPHS 95
+#define FONT_PADDING 4
+
+// ------------------- Jobs -------------------
+typedef enum { JOB_PENDING, JOB_DECODED, JOB_DONE } JobState;
+
+typedef struct {
+    AssetKind kind;
+    AssetGroup group;
+    const char *path;
+    void *target;
+    unsigned spriteMask;    // ASSET_ATLAS
+    int fetchesLeft;        // web: files still downloading
+    atomic_int state;
+    bool fromPack;      // CPU data points into the pack: nothing to free
+
+    // Decoded CPU-side data, handed from a worker to the main thread
+    Image image;
+    Wave wave;
+    GlyphInfo *glyphs;
+    Rectangle *glyphRecs;
+    AtlasImage atlas;
+} LoadJob;
+
+static LoadJob jobs[LOADER_MAX_JOBS];
+static int jobCount = 0;
+static int doneCount = 0;
+static int groupRemaining[ASSET_GROUP_COUNT];
+static atomic_int nextJob;
+static atomic_bool stopping;
+static const Pack *assetPack = NULL;
+static float textureScale = 1.0f;
+
+#if LOADER_THREADS
+static pthread_t workers[LOADER_MAX_THREADS];
+static int workerCount = 0;
+#endif
+
+static void AddJob(AssetKind kind, AssetGroup group, const char *path, void *target, unsigned spriteMask){
+    if(jobCount >= LOADER_MAX_JOBS){
+        TraceLog(LOG_WARNING, "LOADER: job table full, dropping %s", path ? path : "atlas");
+        return;
+    }
+    // Keep jobs ordered by group so workers pick up menu assets first
+    int i = jobCount++;
+    while(i > 0 && jobs[i-1].group > group){
+        jobs[i].kind = jobs[i-1].kind;
+        jobs[i].group = jobs[i-1].group;
+        jobs[i].path = jobs[i-1].path;
+        jobs[i].target = jobs[i-1].target;
+        jobs[i].spriteMask = jobs[i-1].spriteMask;
+        i--;
+    }
+    jobs[i] = (LoadJob){ .kind = kind, .group = group, .path = path, .target = target, .spriteMask = spriteMask };
+    atomic_init(&jobs[i].state, JOB_PENDING);
+    groupRemaining[group]++;
+}
+
+void LoaderAdd(AssetKind kind, AssetGroup group, const char *path, void *target){
+    AddJob(kind, group, path, target, SPRITE_MASK_ALL);
+}
+
+void LoaderAddAtlas(AssetGroup group, unsigned spriteMask, Atlas *target){
+    AddJob(ASSET_ATLAS, group, NULL, target, spriteMask);
+}
+
+void LoaderUsePack(const Pack *pack){
+    assetPack = pack;
+}
+
+void LoaderScaleTextures(float scale){
+    textureScale = scale;
+}
+
+// ------------------- Pack (any thread) -------------------
+static Image PackImage(const char *name){
+    const PackEntry *e = PackFind(assetPack, name);
+    if(!e || e->kind != PACK_TEXTURE) return (Image){0};
+    return (Image){ (void *)PackData(assetPack, e), PACK_TEX_WIDTH(e), PACK_TEX_HEIGHT(e), PACK_TEX_MIPMAPS(e), PACK_TEX_FORMAT(e) };
+}
+
+// Backgrounds carry mips: start from the smallest level that still covers the scale
+static Image PackImageScaled(const char *name, float scale){
+    Image image = PackImage(name);
+    while(image.mipmaps > 1 && image.width/2 >= (int)(image.width*scale + 0.5f)){
+        image.data = (unsigned char *)image.data + GetPixelDataSize(image.width, image.height, image.format);
+        image.width /= 2;
+        image.height /= 2;
+        image.mipmaps--;
+    }
+    return image;
+}
+
+// Fills the job from the pack if it's there; false means fall back to the loose file
+static bool DecodeFromPack(LoadJob *job){
+    const PackEntry *e = PackFind(assetPack, job->kind == ASSET_ATLAS ? "atlas" : job->path);
+    if(!e) return false;
+
+    switch(job->kind){
+        case ASSET_TEXTURE:
+            job->image = PackImageScaled(job->path, textureScale);
+            return job->image.data != NULL;
+        case ASSET_SOUND:
+            if(e->kind != PACK_WAVE) return false;
+            job->wave = (Wave){ PACK_WAVE_FRAMES(e), PACK_WAVE_RATE(e), PACK_WAVE_BITS(e), PACK_WAVE_CHANNELS(e), (void *)PackData(assetPack, e) };
+            return true;
+        case ASSET_FONT: {
+            if(e->kind != PACK_FONT || PACK_FONT_GLYPHS(e) != FONT_GLYPHS || PACK_FONT_SIZE(e) != FONT_SIZE
+               || PACK_FONT_PADDING(e) != FONT_PADDING) return false;
+            char texName[PACK_NAME_MAX + 8];     // not TextFormat: this runs on worker threads
+            snprintf(texName, sizeof(texName), "%s.tex", job->path);
+            job->image = PackImage(texName);
+            if(!job->image.data) return false;
+            // Font owns these arrays (UnloadFont frees them); glyph images stay empty
+            const PackGlyph *src = PackData(assetPack, e);
+            job->glyphs = MemAlloc(FONT_GLYPHS*sizeof(GlyphInfo));
+            job->glyphRecs = MemAlloc(FONT_GLYPHS*sizeof(Rectangle));
+            for(int i=0;i<FONT_GLYPHS;i++){
+                job->glyphs[i] = (GlyphInfo){ src[i].value, src[i].offsetX, src[i].offsetY, src[i].advanceX };
+                job->glyphRecs[i] = (Rectangle){ src[i].x, src[i].y, src[i].width, src[i].height };
+            }
+            return true;
+        }
+        case ASSET_ATLAS: {
+            // The pack holds the whole atlas in one piece
+            if(job->spriteMask != SPRITE_MASK_ALL) return false;
+            if(e->kind != PACK_ATLAS || PACK_ATLAS_SPRITES(e) != SPRITE_COUNT || PACK_ATLAS_PAGES(e) > ATLAS_MAX_PAGES) return false;
+            const PackSprite *src = PackData(assetPack, e);
+            job->atlas.mask = SPRITE_MASK_ALL;
+            job->atlas.pageCount = PACK_ATLAS_PAGES(e);
+            for(int i=0;i<job->atlas.pageCount;i++){
+                char pageName[32];
+                snprintf(pageName, sizeof(pageName), "atlas.page%d", i);
+                job->atlas.pages[i] = PackImage(pageName);
+                if(!job->atlas.pages[i].data) return false;
+            }
+            for(int i=0;i<SPRITE_COUNT;i++){
+                job->atlas.sprites[i] = (SpriteRect){ src[i].page, { src[i].x, src[i].y, src[i].width, src[i].height } };
+            }
+            return true;
+        }
+        case ASSET_FILE:
+            return true;
+    }
+    return false;
+}
+
+// ------------------- Decode (any thread) -------------------
+static void DecodeJob(LoadJob *job){
+    job->fromPack = assetPack && DecodeFromPack(job);
+    if(job->fromPack){
+        atomic_store_explicit(&job->state, JOB_DECODED, memory_order_release);
+        return;
+    }
+
+    switch(job->kind){
+        case ASSET_TEXTURE:
+            job->image = LoadImage(job->path);
+            if(job->image.data && textureScale < 1.0f){
+                ImageResize(&job->image, (int)(job->image.width*textureScale + 0.5f), (int)(job->image.height*textureScale + 0.5f));
+            }
+            break;
+        case ASSET_SOUND: job->wave = LoadWave(job->path); break;
+        case ASSET_FONT: {
+            int size = 0;
+            unsigned char *data = LoadFileData(job->path, &size);
+            if(data){
+                job->glyphs = LoadFontData(data, size, FONT_SIZE, NULL, FONT_GLYPHS, FONT_DEFAULT);
+                if(job->glyphs) job->image = GenImageFontAtlas(job->glyphs, &job->glyphRecs, FONT_GLYPHS, FONT_SIZE, FONT_PADDING, 0);
+                UnloadFileData(data);
+            }
+        } break;
+        case ASSET_ATLAS: AtlasBuildImage(&job->atlas, job->spriteMask); break;
+        case ASSET_FILE: break;
+    }
+    atomic_store_explicit(&job->state, JOB_DECODED, memory_order_release);
+}
+
+static bool DecodeNext(void){
+    if(atomic_load(&stopping)) return false;
+    int i = atomic_fetch_add(&nextJob, 1);
+    if(i >= jobCount) return false;
+    DecodeJob(&jobs[i]);
+    return true;
+}
+
+#if LOADER_THREADS
+static void *LoaderWorker(void *arg){
+    (void)arg;
+    while(DecodeNext()){}
+    return NULL;
+}
+#endif
+
+// ------------------- Upload (main thread) -------------------
+static void UploadJob(LoadJob *job){
+    switch(job->kind){
+        case ASSET_TEXTURE:
+            // From the pack this reads the mapped pixels directly, mips included
+            *(Texture2D *)job->target = LoadTextureFromImage(job->image);
+            if(!job->fromPack) UnloadImage(job->image);
+            break;
+        case ASSET_SOUND:
+            *(Sound *)job->target = LoadSoundFromWave(job->wave);
+            if(!job->fromPack) UnloadWave(job->wave);
+            break;
+        case ASSET_FONT: {
+            Font font = GetFontDefault();
+            if(job->glyphs){
+                font = (Font){ FONT_SIZE, FONT_GLYPHS, FONT_PADDING };
+                font.glyphs = job->glyphs;
+                font.recs = job->glyphRecs;
+                font.texture = LoadTextureFromImage(job->image);
+                if(!job->fromPack) UnloadImage(job->image);
+            }else TraceLog(LOG_WARNING, "LOADER: failed to load font %s, using default", job->path);
+            *(Font *)job->target = font;
+        } break;
+        case ASSET_ATLAS:
+            AtlasAppend(job->target, &job->atlas);
+            if(!job->fromPack) UnloadAtlasImage(&job->atlas);
+            break;
+        case ASSET_FILE:
+            // Opened later by someone else; say now that it won't be there
+            if(!job->fromPack && !FileExists(job->path)) TraceLog(LOG_WARNING, "LOADER: %s is missing", job->path);
+            break;
+    }
+    atomic_store(&job->state, JOB_DONE);
+    doneCount++;
+    groupRemaining[job->group]--;
+}
+
+// ------------------- Fetch (web) -------------------
+#if defined(PLATFORM_WEB)
+static size_t fetchedBytes = 0;
+static int fetchesPending = 0;
+
+static void FetchDone(LoadJob *job){
+    job->fetchesLeft--;
+    if(--fetchesPending == 0) TraceLog(LOG_INFO, "LOADER: background fetch done, %zu bytes", fetchedBytes);
+}
+
+static void OnFetched(unsigned handle, void *arg, const char *file){
+    (void)handle;
+    fetchedBytes += GetFileLength(file);
+    FetchDone(arg);
+}
+
+static void OnFetchFailed(unsigned handle, void *arg, int status){
+    (void)handle;
+    LoadJob *job = arg;
+    TraceLog(LOG_WARNING, "LOADER: fetch for %s failed (HTTP %d)", job->path ? job->path : "atlas", status);
+    FetchDone(job);     // decoding the missing file then fails the usual way
+}
+
+// Files preloaded with the page are already in the virtual filesystem
+static void FetchFile(LoadJob *job, const char *path){
+    if(FileExists(path)) return;
+    char dir[256];
+    snprintf(dir, sizeof(dir), "%s", path);
+    for(char *p = strchr(dir + 1, '/'); p; p = strchr(p + 1, '/')){
+        *p = '\0';
+        mkdir(dir, 0755);   // the download lands in the parent directory
+        *p = '/';
+    }
+    job->fetchesLeft++;
+    fetchesPending++;
+    emscripten_async_wget2(path, path, "GET", "", job, OnFetched, OnFetchFailed, NULL);
+}
+
+static void FetchJobs(void){
+    for(int i=0;i<jobCount;i++){
+        LoadJob *job = &jobs[i];
+        if(job->kind != ASSET_ATLAS) FetchFile(job, job->path);
+        else for(int s=0;s<SPRITE_COUNT;s++) if(job->spriteMask & SPRITE_BIT(s)) FetchFile(job, spritePaths[s]);
+    }
+    if(fetchesPending) TraceLog(LOG_INFO, "LOADER: fetching %d file(s) in the background", fetchesPending);
+}
+#endif
+
+void LoaderStart(int threads){
+    atomic_store(&nextJob, 0);
+    atomic_store(&stopping, false);
+#if defined(PLATFORM_WEB)
+    FetchJobs();
+#endif
+#if LOADER_THREADS
+    if(threads <= 0) threads = LOADER_MAX_THREADS;
+    if(threads > LOADER_MAX_THREADS) threads = LOADER_MAX_THREADS;
+    for(int i=0;i<threads;i++){
+        if(pthread_create(&workers[workerCount], NULL, LoaderWorker, NULL) == 0) workerCount++;
+    }
+    TraceLog(LOG_INFO, "LOADER: %d assets on %d worker thread(s)%s", jobCount, workerCount, assetPack ? ", from pack" : "");
+#else
+    (void)threads;
+    TraceLog(LOG_INFO, "LOADER: %d assets, decoding on the main thread", jobCount);
+#endif
+}
+
+// Uploads decoded jobs in queue order, so a group never finishes before an earlier one
+void LoaderPump(double budgetSeconds){
+    double start = GetTime();
+    for(int i=0;i<jobCount;i++){
+        LoadJob *job = &jobs[i];
+        int state = atomic_load_explicit(&job->state, memory_order_acquire);
+        if(state == JOB_DONE) continue;
+
+        if(state == JOB_PENDING){
+            if(job->fetchesLeft > 0) break;     // still downloading
+#if LOADER_THREADS
+            if(workerCount > 0) break;
+#endif
+            // No workers: decode here, within the same frame budget
+            if(!DecodeNext()) break;
+            state = atomic_load(&job->state);
+            if(state != JOB_DECODED) break;
+        }
+
+        UploadJob(job);
+        if(GetTime() - start > budgetSeconds) break;
+    }
+}
+
+bool LoaderGroupReady(AssetGroup group){
+    for(int g=0;g<=group;g++) if(groupRemaining[g] > 0) return false;
+    return true;
+}
+
+bool LoaderDone(void){
+    return doneCount == jobCount;
+}
+
+float LoaderProgress(void){
+    return jobCount ? (float)doneCount/jobCount : 1.0f;
+}
+
+void LoaderShutdown(void){
+    atomic_store(&stopping, true);
+#if LOADER_THREADS
+    for(int i=0;i<workerCount;i++) pthread_join(workers[i], NULL);
+    workerCount = 0;
+#endif
+    // Drop whatever was decoded but never uploaded
+    for(int i=0;i<jobCount;i++){
+        LoadJob *job = &jobs[i];
+        if(atomic_load(&job->state) != JOB_DECODED) continue;
+        if(job->fromPack){
+            if(job->kind == ASSET_FONT){ MemFree(job->glyphs); MemFree(job->glyphRecs); }
+            atomic_store(&job->state, JOB_PENDING);
+            continue;
+        }
+        switch(job->kind){
+            case ASSET_TEXTURE: UnloadImage(job->image); break;
+            case ASSET_SOUND: UnloadWave(job->wave); break;
+            case ASSET_FONT: UnloadImage(job->image); UnloadFontData(job->glyphs, FONT_GLYPHS); MemFree(job->glyphRecs); break;
+            case ASSET_ATLAS: UnloadAtlasImage(&job->atlas); break;
+            case ASSET_FILE: break;
+        }
+        atomic_store(&job->state, JOB_PENDING);
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef LOADER_H
+#define LOADER_H
+
+// Asynchronous asset loading. Worker threads decode files into CPU memory
+// (images, waves, font glyphs, the sprite atlas); the main thread uploads each
+// one to the GPU/audio device as soon as it is ready, a few per frame.
+// Groups finish in order, so the menu can run before game-only assets arrive.
+// With an asset pack, "decoding" is just pointing into the mapped file.
+// On the web, files that weren't preloaded with the page are fetched into the
+// virtual filesystem first, so later groups stream in while the menu runs.
+
+#include "raylib.h"
+#include "pack.h"
+#include "atlas.h"
+
+#define LOADER_MAX_JOBS 32
+
+typedef enum { ASSET_TEXTURE, ASSET_SOUND, ASSET_FONT, ASSET_ATLAS, ASSET_FILE } AssetKind;
+typedef enum { ASSET_GROUP_MENU, ASSET_GROUP_GAME, ASSET_GROUP_COUNT } AssetGroup;
+
+// target points at the Texture2D/Sound/Font/Atlas to fill in; path is unused for ASSET_ATLAS.
+// ASSET_FILE checks the file is in the pack or on disk (fetched first on the web) and warns if
+// not; target unused, for assets opened elsewhere.
+void LoaderAdd(AssetKind kind, AssetGroup group, const char *path, void *target);
+void LoaderAddAtlas(AssetGroup group, unsigned spriteMask, Atlas *target);     // part of the atlas; see SPRITE_MASK_*
+void LoaderUsePack(const Pack *pack);   // assets found in the pack skip decoding entirely
+void LoaderScaleTextures(float scale);  // ASSET_TEXTURE (full-screen backgrounds) at this fraction of their size
+void LoaderStart(int threads);          // threads <= 0 picks a default
+void LoaderPump(double budgetSeconds);  // main thread, once per frame
+bool LoaderGroupReady(AssetGroup group);
+bool LoaderDone(void);
+float LoaderProgress(void);             // 0..1, by job count
+void LoaderShutdown(void);              // waits for workers, frees anything not uploaded
+
+#endif
@@ -0,0 +1,691 @@
+#if !defined(_WIN32)
+    #define _POSIX_C_SOURCE 200112L     // getaddrinfo under -std=c11
+#endif
+#include "net.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// No raylib here, so the platform headers can't clash with its names
+#if defined(__EMSCRIPTEN__)
+    #define NET_NO_SOCKETS 1
+#elif defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+    typedef int socklen_t;
+#else
+    #include <arpa/inet.h>
+    #include <fcntl.h>
+    #include <netdb.h>
+    #include <netinet/in.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
+enum { MSG_HELLO = 1, MSG_WELCOME, MSG_REJECT, MSG_INPUT, MSG_SNAPSHOT };
+
+// ------------------- Platform Sockets -------------------
+#if defined(NET_NO_SOCKETS)
+static bool RawOpen(intptr_t *handle, uint16_t port){ (void)handle; (void)port; return false; }
+static void RawClose(intptr_t handle){ (void)handle; }
+static void RawSend(intptr_t handle, NetAddress to, const uint8_t *data, int size){ (void)handle; (void)to; (void)data; (void)size; }
+static int RawRecv(intptr_t handle, NetAddress *from, uint8_t *buf, int cap){ (void)handle; (void)from; (void)buf; (void)cap; return -1; }
+static bool Resolve(const char *host, uint32_t *ip){ (void)host; (void)ip; return false; }
+#else
+static void RawClose(intptr_t handle){
+#if defined(_WIN32)
+    closesocket((SOCKET)handle);
+#else
+    close((int)handle);
+#endif
+}
+
+static bool RawOpen(intptr_t *handle, uint16_t port){
+#if defined(_WIN32)
+    static bool started = false;
+    if(!started){
+        WSADATA wsa;
+        if(WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return false;
+        started = true;
+    }
+    SOCKET s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if(s == INVALID_SOCKET) return false;
+    u_long nonBlocking = 1;
+    ioctlsocket(s, FIONBIO, &nonBlocking);
+#else
+    int s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if(s < 0) return false;
+    fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+#endif
+    struct sockaddr_in addr = {0};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if(bind(s, (struct sockaddr *)&addr, sizeof(addr)) != 0){
+        RawClose((intptr_t)s);
+        return false;
+    }
+    *handle = (intptr_t)s;
+    return true;
+}
+
+static void RawSend(intptr_t handle, NetAddress to, const uint8_t *data, int size){
+    struct sockaddr_in addr = {0};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(to.ip);
+    addr.sin_port = htons(to.port);
+    sendto(handle, (const char *)data, size, 0, (struct sockaddr *)&addr, sizeof(addr));
+}
+
+static int RawRecv(intptr_t handle, NetAddress *from, uint8_t *buf, int cap){
+    struct sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    int n = (int)recvfrom(handle, (char *)buf, cap, 0, (struct sockaddr *)&addr, &len);
+    if(n <= 0) return -1;
+    from->ip = ntohl(addr.sin_addr.s_addr);
+    from->port = ntohs(addr.sin_port);
+    return n;
+}
+
+static bool Resolve(const char *host, uint32_t *ip){
+    struct addrinfo hints = {0}, *res = NULL;
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    if(getaddrinfo(host, NULL, &hints, &res) != 0 || !res) return false;
+    *ip = ntohl(((struct sockaddr_in *)res->ai_addr)->sin_addr.s_addr);
+    freeaddrinfo(res);
+    return true;
+}
+#endif
+
+// ------------------- Conditioned Socket -------------------
+static bool SocketOpen(NetSocket *s, uint16_t port, const NetConditions *conditions){
+    memset(s, 0, sizeof(*s));
+    if(conditions) s->conditions = *conditions;
+    SimRngSeed(&s->rng, (uint64_t)time(NULL), port);
+    return RawOpen(&s->handle, port);
+}
+
+static void SocketClose(NetSocket *s){
+    RawClose(s->handle);
+    s->handle = 0;
+}
+
+static void SocketSend(NetSocket *s, NetAddress to, const uint8_t *data, int size, double now){
+    s->packetsSent++;
+    s->bytesSent += (uint64_t)size;
+    if(s->conditions.loss > 0 && SimRngFloat(&s->rng) < s->conditions.loss){ s->packetsLost++; return; }
+
+    double delay = s->conditions.latency + s->conditions.jitter*SimRngFloat(&s->rng);
+    if(delay <= 0){ RawSend(s->handle, to, data, size); return; }
+    if(s->queueCount == NET_DELAY_QUEUE){ s->packetsLost++; return; }
+    NetDelayed *d = &s->queue[s->queueCount++];
+    d->sendAt = now + delay;
+    d->to = to;
+    d->size = (uint16_t)size;
+    memcpy(d->data, data, (size_t)size);
+}
+
+// Releases delayed packets that are due, keeping the rest in order
+static void SocketFlush(NetSocket *s, double now){
+    int kept = 0;
+    for(int i=0;i<s->queueCount;i++){
+        if(s->queue[i].sendAt <= now) RawSend(s->handle, s->queue[i].to, s->queue[i].data, s->queue[i].size);
+        else{
+            if(kept != i) s->queue[kept] = s->queue[i];
+            kept++;
+        }
+    }
+    s->queueCount = kept;
+}
+
+static int SocketRecv(NetSocket *s, NetAddress *from, uint8_t *buf, int cap){
+    int n = RawRecv(s->handle, from, buf, cap);
+    if(n > 0){
+        s->packetsReceived++;
+        s->bytesReceived += (uint64_t)n;
+    }
+    return n;
+}
+
+// ------------------- Packet Encoding -------------------
+typedef struct { uint8_t *p, *end; } Writer;
+typedef struct { const uint8_t *p, *end; bool ok; } Reader;
+
+static void Put(Writer *w, uint64_t v, int bytes){
+    for(int i=0;i<bytes;i++){ if(w->p < w->end) *w->p = (uint8_t)(v >> (8*i)); w->p++; }
+}
+
+static void PutF64(Writer *w, double d){
+    uint64_t v;
+    memcpy(&v, &d, 8);
+    Put(w, v, 8);
+}
+
+static uint64_t Get(Reader *r, int bytes){
+    if(r->end - r->p < bytes){ r->ok = false; r->p = r->end; return 0; }
+    uint64_t v = 0;
+    for(int i=0;i<bytes;i++) v |= (uint64_t)*r->p++ << (8*i);
+    return v;
+}
+
+static double GetF64(Reader *r){
+    uint64_t v = Get(r, 8);
+    double d;
+    memcpy(&d, &v, 8);
+    return d;
+}
+
+static void PutVarint(Writer *w, uint32_t v){
+    while(v >= 0x80){ Put(w, (v & 0x7F) | 0x80, 1); v >>= 7; }
+    Put(w, v, 1);
+}
+
+static uint32_t GetVarint(Reader *r){
+    uint32_t v = 0;
+    for(int shift=0;shift<32;shift+=7){
+        uint32_t b = (uint32_t)Get(r, 1);
+        v |= (b & 0x7F) << shift;
+        if(!(b & 0x80)) return v;
+    }
+    r->ok = false;
+    return 0;
+}
+
+// Delta against base (XOR; bytes past the base's end count as zero), then runs:
+// [unchanged count][changed count][changed bytes]... Unchanged stretches shorter
+// than 3 bytes stay inside the changed run.
+static void RleEncode(Writer *w, const uint8_t *cur, int size, const uint8_t *base, int baseSize){
+    #define DIFF(i) (uint8_t)(cur[i] ^ ((i) < baseSize ? base[i] : 0))
+    int i = 0;
+    while(i < size){
+        int zeros = 0;
+        while(i + zeros < size && DIFF(i + zeros) == 0) zeros++;
+        i += zeros;
+        int lits = 0;
+        while(i + lits < size){
+            if(DIFF(i + lits) != 0){ lits++; continue; }
+            int z = 0;
+            while(i + lits + z < size && z < 3 && DIFF(i + lits + z) == 0) z++;
+            if(z >= 3 || i + lits + z == size) break;
+            lits += z;
+        }
+        PutVarint(w, (uint32_t)zeros);
+        PutVarint(w, (uint32_t)lits);
+        for(int k=0;k<lits;k++) Put(w, DIFF(i + k), 1);
+        i += lits;
+    }
+    #undef DIFF
+}
+
+static bool RleDecode(Reader *r, uint8_t *out, int size, const uint8_t *base, int baseSize){
+    int i = 0;
+    while(i < size && r->ok){
+        uint32_t zeros = GetVarint(r), lits = GetVarint(r);
+        if(zeros > (uint32_t)(size - i) || lits > (uint32_t)(size - i) - zeros) return false;
+        for(uint32_t k=0;k<zeros;k++, i++) out[i] = i < baseSize ? base[i] : 0;
+        for(uint32_t k=0;k<lits;k++, i++) out[i] = (uint8_t)Get(r, 1) ^ (i < baseSize ? base[i] : 0);
+    }
+    return r->ok && i == size;
+}
+
+// ------------------- Statistics -------------------
+static int CompareFloat(const void *a, const void *b){
+    float x = *(const float *)a, y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+float NetRttPercentile(const NetStats *stats, float p){
+    int n = stats->rttCount < NET_RTT_SAMPLES ? stats->rttCount : NET_RTT_SAMPLES;
+    if(n == 0) return 0;
+    float sorted[NET_RTT_SAMPLES];
+    memcpy(sorted, stats->rttMs, (size_t)n*sizeof(float));
+    qsort(sorted, (size_t)n, sizeof(float), CompareFloat);
+    int i = (int)(p*(n - 1) + 0.5f);
+    return sorted[i];
+}
+
+// ------------------- Server -------------------
+static bool SameAddress(NetAddress a, NetAddress b){
+    return a.ip == b.ip && a.port == b.port;
+}
+
+static int FindPeer(const NetServer *s, NetAddress from){
+    for(int t=0;t<s->teamCount;t++) if(s->peers[t].active && SameAddress(s->peers[t].address, from)) return t;
+    return -1;
+}
+
+static bool AllJoined(const NetServer *s){
+    for(int t=0;t<s->teamCount;t++) if(!s->peers[t].active) return false;
+    return true;
+}
+
+static void StartMatch(NetServer *s, double now){
+    s->matchId++;
+    s->match.board = NULL;
+    s->match.teamCount = s->teamCount;
+    SimInit(&s->match, (uint64_t)time(NULL) ^ ((uint64_t)s->matchId << 32));
+    s->running = true;
+    s->clock = now;
+    s->nextSnapshot = now;
+    s->restartAt = 0;
+    s->hitCount = 0;
+    for(int t=0;t<s->teamCount;t++) s->peers[t].appliedSeq = s->peers[t].queuedSeq;
+    printf("NET: match %u started\n", s->matchId);
+}
+
+bool NetServerStart(NetServer *server, uint16_t port, int teamCount, const NetConditions *conditions){
+    memset(server, 0, sizeof(*server));
+    server->teamCount = (teamCount < 1) ? 1 : (teamCount > SIM_MAX_TEAMS) ? SIM_MAX_TEAMS : teamCount;
+    if(!SocketOpen(&server->socket, port, conditions)){
+        fprintf(stderr, "NET: cannot open UDP port %u\n", port);
+        return false;
+    }
+    printf("NET: server on port %u, waiting for %d teams\n", port, server->teamCount);
+    return true;
+}
+
+static void ServerReceive(NetServer *s, double now){
+    uint8_t buf[NET_MAX_PACKET], reply[8];
+    NetAddress from;
+    int n;
+    while((n = SocketRecv(&s->socket, &from, buf, sizeof(buf))) > 0){
+        Reader r = { buf, buf + n, true };
+        int type = (int)Get(&r, 1);
+
+        if(type == MSG_HELLO){
+            int want = (int)Get(&r, 1);
+            int team = FindPeer(s, from);
+            if(team < 0 && want < s->teamCount && !s->peers[want].active) team = want;
+            for(int t=0;t<s->teamCount && team<0;t++) if(!s->peers[t].active) team = t;
+
+            Writer w = { reply, reply + sizeof(reply) };
+            if(team < 0){
+                Put(&w, MSG_REJECT, 1);
+            }else{
+                NetPeer *p = &s->peers[team];
+                if(!p->active){
+                    memset(p, 0, sizeof(*p));
+                    p->active = true;
+                    p->address = from;
+                    p->queuedSeq = p->appliedSeq = 0;
+                    printf("NET: team %d joined\n", team);
+                }
+                p->lastHeard = now;
+                Put(&w, MSG_WELCOME, 1);
+                Put(&w, (uint32_t)team, 1);
+                Put(&w, (uint32_t)s->teamCount, 1);
+            }
+            SocketSend(&s->socket, from, reply, (int)(w.p - reply), now);
+        }
+        else if(type == MSG_INPUT){
+            int team = FindPeer(s, from);
+            if(team < 0) continue;
+            NetPeer *p = &s->peers[team];
+            Get(&r, 1);     // team, implied by the address
+            uint32_t ackMatch = (uint32_t)Get(&r, 4), ackTick = (uint32_t)Get(&r, 4);
+            double pingTime = GetF64(&r);
+            int count = (int)Get(&r, 1);
+            if(!r.ok) continue;
+
+            p->lastHeard = now;
+            p->ackMatch = ackMatch;
+            p->ackTick = ackTick;
+            p->pingTime = pingTime;
+            p->pingReceived = now;
+
+            for(int i=0;i<count;i++){
+                uint32_t seq = (uint32_t)Get(&r, 4), tick = (uint32_t)Get(&r, 4);
+                int hole = (int)Get(&r, 2);
+                if(!r.ok || seq <= p->queuedSeq) continue;
+                p->queuedSeq = seq;
+                // Hits for another match, or one that's over, only get acknowledged
+                if(!s->running || ackMatch != s->matchId || s->hitCount == (int)(sizeof(s->hits)/sizeof(s->hits[0]))){
+                    if(!s->running || ackMatch != s->matchId) p->appliedSeq = seq;
+                    continue;
+                }
+                // A clock running far ahead can't queue hits for later than half a second
+                if(tick > s->match.tick + SIM_TICK_HZ/2) tick = s->match.tick + SIM_TICK_HZ/2;
+                s->hits[s->hitCount++] = (NetPendingHit){ seq, tick, (uint16_t)hole, (uint8_t)team };
+            }
+        }
+    }
+}
+
+// Hits due on or before this tick go in; late ones land now
+static void ServerStep(NetServer *s){
+    SimInput input;
+    input.count = 0;
+    uint32_t next = s->match.tick + 1;
+    int kept = 0;
+    for(int i=0;i<s->hitCount;i++){
+        NetPendingHit h = s->hits[i];
+        if(h.tick <= next){
+            SimInputAdd(&input, h.hole, h.team);
+            if(h.seq > s->peers[h.team].appliedSeq) s->peers[h.team].appliedSeq = h.seq;
+        }else s->hits[kept++] = h;
+    }
+    s->hitCount = kept;
+    SimStep(&s->match, &input);
+}
+
+static void ServerSendSnapshots(NetServer *s, double now){
+    int last = (s->ringHead + NET_SNAPSHOT_RING - 1) % NET_SNAPSHOT_RING;
+    if(!(s->ring[last].size && s->ring[last].matchId == s->matchId && s->ring[last].tick == s->match.tick)){
+        last = s->ringHead;
+        s->ringHead = (s->ringHead + 1) % NET_SNAPSHOT_RING;
+        s->ring[last].matchId = s->matchId;
+        s->ring[last].tick = s->match.tick;
+        s->ring[last].size = (uint16_t)SimSave(&s->match, s->ring[last].data, NET_MAX_SNAPSHOT);
+        if(!s->ring[last].size){
+            fprintf(stderr, "NET: match state doesn't fit in a snapshot\n");
+            return;
+        }
+    }
+    const uint8_t *cur = s->ring[last].data;
+    int size = s->ring[last].size;
+
+    for(int t=0;t<s->teamCount;t++){
+        NetPeer *p = &s->peers[t];
+        if(!p->active) continue;
+
+        const uint8_t *base = NULL;
+        int baseSize = 0;
+        for(int i=0;i<NET_SNAPSHOT_RING && p->ackMatch == s->matchId;i++){
+            if(s->ring[i].size && s->ring[i].matchId == s->matchId && s->ring[i].tick == p->ackTick){
+                base = s->ring[i].data;
+                baseSize = s->ring[i].size;
+                break;
+            }
+        }
+
+        uint8_t packet[NET_MAX_PACKET];
+        Writer w = { packet, packet + sizeof(packet) };
+        Put(&w, MSG_SNAPSHOT, 1);
+        Put(&w, s->matchId, 4);
+        Put(&w, s->match.tick, 4);
+        Put(&w, base != NULL, 1);
+        Put(&w, base ? p->ackTick : 0, 4);
+        Put(&w, p->appliedSeq, 4);
+        PutF64(&w, p->pingReceived > 0 ? p->pingTime + (now - p->pingReceived) : 0.0);
+        Put(&w, (uint32_t)size, 2);
+        RleEncode(&w, cur, size, base, baseSize);
+        if(w.p > w.end){
+            fprintf(stderr, "NET: snapshot too large for a packet\n");
+            continue;
+        }
+        SocketSend(&s->socket, p->address, packet, (int)(w.p - packet), now);
+    }
+}
+
+void NetServerUpdate(NetServer *server, double now){
+    NetServer *s = server;
+    ServerReceive(s, now);
+
+    for(int t=0;t<s->teamCount;t++){
+        if(s->peers[t].active && now - s->peers[t].lastHeard > 5.0){
+            s->peers[t].active = false;
+            printf("NET: team %d timed out\n", t);
+        }
+    }
+
+    if(!s->running && AllJoined(s) && (s->matchId == 0 || (s->restartAt > 0 && now >= s->restartAt))) StartMatch(s, now);
+
+    if(s->running){
+        if(now - s->clock > 0.25) s->clock = now - 0.25;
+        while(s->clock + SIM_DT <= now && !SimIsOver(&s->match)){
+            ServerStep(s);
+            s->clock += SIM_DT;
+        }
+        if(SimIsOver(&s->match)){
+            s->running = false;
+            s->restartAt = now + 5.0;
+            printf("NET: match %u over:", s->matchId);
+            for(int t=0;t<s->teamCount;t++) printf(" %d", s->match.scores[t]);
+            printf("\n");
+        }
+    }
+
+    // Keeps going after the round ends, so lost final snapshots get repaired
+    if(s->matchId && now >= s->nextSnapshot){
+        s->nextSnapshot += NET_SNAPSHOT_INTERVAL*SIM_DT;
+        if(s->nextSnapshot < now) s->nextSnapshot = now;
+        ServerSendSnapshots(s, now);
+    }
+    SocketFlush(&s->socket, now);
+}
+
+void NetServerStop(NetServer *server){
+    SocketClose(&server->socket);
+    SimFree(&server->match);
+}
+
+// ------------------- Client -------------------
+bool NetClientConnect(NetClient *client, Match *match, const char *host, uint16_t port, int team, const NetConditions *conditions){
+    memset(client, 0, sizeof(*client));
+    client->match = match;
+    client->team = -1;
+    client->wantTeam = (team >= 0 && team < SIM_MAX_TEAMS) ? team : 255;
+    client->lastHello = -1e9;
+    memset(client->historyTick, 0xFF, sizeof(client->historyTick));
+
+    uint32_t ip;
+    if(!Resolve(host, &ip)){
+        fprintf(stderr, "NET: cannot resolve %s\n", host);
+        return false;
+    }
+    if(!SocketOpen(&client->socket, 0, conditions)){
+        fprintf(stderr, "NET: cannot open a UDP socket\n");
+        return false;
+    }
+    client->server = (NetAddress){ ip, port };
+    return true;
+}
+
+static void Remember(NetClient *c, uint32_t tick, uint64_t hash){
+    c->historyTick[tick % NET_HISTORY] = tick;
+    c->historyHash[tick % NET_HISTORY] = hash;
+}
+
+static uint64_t HashMatch(const Match *m){
+    uint8_t buf[NET_MAX_SNAPSHOT];
+    size_t n = SimSave(m, buf, sizeof(buf));
+    return SimHash(buf, n);
+}
+
+// One predicted tick: our hits due by now go in (late ones after a reload too)
+static void ClientStep(NetClient *c){
+    Match *m = c->match;
+    uint32_t next = m->tick + 1;
+    SimInput input;
+    input.count = 0;
+    for(int i=0;i<c->pendingCount;i++){
+        NetHit *h = &c->pending[i];
+        if(!h->applied && h->tick <= next){
+            SimInputAdd(&input, h->hole, c->team);
+            h->applied = true;
+        }
+    }
+    SimStep(m, &input);
+    Remember(c, m->tick, HashMatch(m));
+}
+
+// Server state replaces the prediction; our unacknowledged hits are replayed on top
+static void Reconcile(NetClient *c, uint32_t matchId, uint32_t tick, const uint8_t *state, int size, double now){
+    Match *m = c->match;
+    bool newMatch = !c->live || matchId != c->matchId;
+    if(!newMatch && tick <= c->authTick) return;    // late duplicate
+
+    uint64_t hash = SimHash(state, (size_t)size);
+    uint32_t present = m->tick;
+    if(!newMatch && tick <= present && c->historyTick[tick % NET_HISTORY] == tick && c->historyHash[tick % NET_HISTORY] == hash){
+        c->authTick = tick;
+        c->authReceived = now;
+        return;     // predicted right
+    }
+
+    SimEventFn onEvent = m->onEvent;
+    m->onEvent = NULL;      // replayed ticks already made their sounds
+    if(!SimLoad(m, state, (size_t)size)){
+        m->onEvent = onEvent;
+        return;
+    }
+    c->authTick = tick;
+    c->authReceived = now;
+    Remember(c, tick, hash);
+
+    if(newMatch){
+        c->live = true;
+        c->matchId = matchId;
+        c->pendingCount = 0;
+        c->clock = now;
+        memset(c->historyTick, 0xFF, sizeof(c->historyTick));
+        Remember(c, tick, hash);
+    }else{
+        for(int i=0;i<c->pendingCount;i++) c->pending[i].applied = false;
+        while(m->tick < present && !SimIsOver(m)){
+            ClientStep(c);
+            c->stats.resimulatedTicks++;
+        }
+        // Hits made since the last step were applied straight away; do that again
+        for(int i=0;i<c->pendingCount;i++){
+            NetHit *h = &c->pending[i];
+            if(!h->applied && h->tick > m->tick){
+                SimHit(m, h->hole, c->team);
+                h->applied = true;
+            }
+        }
+        if(tick <= present) c->stats.rollbacks++;
+    }
+    m->onEvent = onEvent;
+}
+
+static void ClientReceive(NetClient *c, double now){
+    uint8_t buf[NET_MAX_PACKET], state[NET_MAX_SNAPSHOT];
+    NetAddress from;
+    int n;
+    while((n = SocketRecv(&c->socket, &from, buf, sizeof(buf))) > 0){
+        if(!SameAddress(from, c->server)) continue;
+        Reader r = { buf, buf + n, true };
+        int type = (int)Get(&r, 1);
+
+        if(type == MSG_WELCOME){
+            int team = (int)Get(&r, 1);
+            if(r.ok && c->team != team){
+                c->team = team;
+                printf("NET: joined as team %d of %d\n", team, (int)Get(&r, 1));
+            }
+        }
+        else if(type == MSG_REJECT){
+            if(c->team < 0) fprintf(stderr, "NET: server is full\n");
+        }
+        else if(type == MSG_SNAPSHOT){
+            uint32_t matchId = (uint32_t)Get(&r, 4), tick = (uint32_t)Get(&r, 4);
+            bool hasBase = Get(&r, 1) != 0;
+            uint32_t baseTick = (uint32_t)Get(&r, 4), ackSeq = (uint32_t)Get(&r, 4);
+            double echo = GetF64(&r);
+            int size = (int)Get(&r, 2);
+            if(!r.ok || size > NET_MAX_SNAPSHOT) continue;
+
+            const uint8_t *base = NULL;
+            int baseSize = 0;
+            if(hasBase){
+                if(matchId != c->matchId) continue;
+                for(int i=0;i<NET_CLIENT_RING;i++){
+                    if(c->ring[i].size && c->ring[i].tick == baseTick){ base = c->ring[i].data; baseSize = c->ring[i].size; break; }
+                }
+                if(!base) continue;     // base already dropped: wait for one we can decode
+            }
+            if(!RleDecode(&r, state, size, base, baseSize)) continue;
+
+            c->stats.snapshots++;
+            c->stats.snapshotBytes += (uint64_t)n;
+            if(!hasBase) c->stats.fullSnapshots++;
+            if(echo > 0) c->stats.rttMs[c->stats.rttCount++ % NET_RTT_SAMPLES] = (float)((now - echo)*1000.0);
+
+            if(matchId != c->matchId) memset(c->ring, 0, sizeof(c->ring));
+            c->ring[c->ringHead].tick = tick;
+            c->ring[c->ringHead].size = (uint16_t)size;
+            memcpy(c->ring[c->ringHead].data, state, (size_t)size);
+            c->ringHead = (c->ringHead + 1) % NET_CLIENT_RING;
+
+            if(matchId == c->matchId){
+                int kept = 0;
+                for(int i=0;i<c->pendingCount;i++) if(c->pending[i].seq > ackSeq) c->pending[kept++] = c->pending[i];
+                c->pendingCount = kept;
+            }
+            Reconcile(c, matchId, tick, state, size, now);
+        }
+    }
+}
+
+// Runs ahead of the server by a round trip plus a margin, so our hits reach it before their tick
+static void ClientAdvance(NetClient *c, double now){
+    Match *m = c->match;
+    double lead = NetRttPercentile(&c->stats, 0.5f)/1000.0 + 0.02;
+    double target = c->authTick + (now - c->authReceived + lead)*SIM_TICK_HZ;
+
+    if(now - c->clock > 0.25) c->clock = now - 0.25;
+    while(c->clock + SIM_DT <= now){
+        c->clock += SIM_DT;
+        if(m->tick > target + 2) continue;      // ahead: hold a tick
+        if(!SimIsOver(m)) ClientStep(c);
+        if(m->tick + 2 < target && !SimIsOver(m)) ClientStep(c);   // behind: catch up
+    }
+    for(int guard=0;m->tick + SIM_TICK_HZ/4 < target && !SimIsOver(m) && guard<SIM_TICK_HZ;guard++) ClientStep(c);
+}
+
+static void ClientSend(NetClient *c, double now){
+    uint8_t packet[NET_MAX_PACKET];
+    Writer w = { packet, packet + sizeof(packet) };
+    if(c->team < 0){
+        Put(&w, MSG_HELLO, 1);
+        Put(&w, (uint32_t)c->wantTeam, 1);
+        c->lastHello = now;
+    }else{
+        Put(&w, MSG_INPUT, 1);
+        Put(&w, (uint32_t)c->team, 1);
+        Put(&w, c->matchId, 4);
+        Put(&w, c->authTick, 4);
+        PutF64(&w, now);
+        // Every unacknowledged hit, every time: a lost packet costs nothing
+        Put(&w, (uint32_t)c->pendingCount, 1);
+        for(int i=0;i<c->pendingCount;i++){
+            Put(&w, c->pending[i].seq, 4);
+            Put(&w, c->pending[i].tick, 4);
+            Put(&w, c->pending[i].hole, 2);
+        }
+    }
+    SocketSend(&c->socket, c->server, packet, (int)(w.p - packet), now);
+    c->lastSend = now;
+    c->sendNow = false;
+}
+
+void NetClientHit(NetClient *client, int hole){
+    NetClient *c = client;
+    if(!c->live || c->team < 0 || SimIsOver(c->match) || c->pendingCount == NET_MAX_PENDING) return;
+    NetHit *h = &c->pending[c->pendingCount++];
+    h->seq = ++c->nextSeq;
+    h->tick = c->match->tick + 1;
+    h->hole = (uint16_t)hole;
+    h->applied = true;
+    SimHit(c->match, hole, c->team);
+    c->sendNow = true;
+}
+
+void NetClientUpdate(NetClient *client, double now){
+    NetClient *c = client;
+    ClientReceive(c, now);
+    if(c->team >= 0 && c->live) ClientAdvance(c, now);
+
+    if(c->team < 0){
+        if(now - c->lastHello >= 0.5) ClientSend(c, now);
+    }else if(c->sendNow || now - c->lastSend >= 1.0/60) ClientSend(c, now);
+    SocketFlush(&c->socket, now);
+}
+
+void NetClientDisconnect(NetClient *client){
+    SocketClose(&client->socket);
+}
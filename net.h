@@ -0,0 +1,148 @@
+#ifndef NET_H
+#define NET_H
+
+// LAN multiplayer over UDP. The server owns the match: it spawns the moles,
+// applies every team's hits and sends snapshots, XOR-delta'd against the last
+// snapshot the client acknowledged and then run-length coded. A client applies
+// its own hits at once (sound and hammer feel local) and, when a snapshot
+// disagrees with what it predicted for that tick, reloads the server state and
+// re-simulates its unacknowledged hits up to the present.
+// Matches use the built-in board. No raylib dependency; no UDP on the web;
+// Windows builds link ws2_32.
+
+#include "sim.h"
+
+#define NET_DEFAULT_PORT 7777
+#define NET_MAX_PACKET 1400
+#define NET_MAX_SNAPSHOT 1200           // raw SimSave() image
+#define NET_SNAPSHOT_INTERVAL 4         // ticks between snapshots (30 Hz)
+#define NET_SNAPSHOT_RING 32            // server: recent snapshots kept as delta bases
+#define NET_CLIENT_RING 16              // client: received snapshots kept as delta bases
+#define NET_HISTORY 256                 // client: predicted-state hashes, by tick
+#define NET_MAX_PENDING 32              // client: hits not yet acknowledged
+#define NET_DELAY_QUEUE 128
+
+typedef struct { uint32_t ip; uint16_t port; } NetAddress;     // host byte order
+
+// ------------------- Sockets -------------------
+// Link conditioner, applied on send: for testing on one machine
+typedef struct {
+    double latency;     // seconds, one way
+    double jitter;      // seconds, uniform 0..jitter added
+    float loss;         // 0..1
+} NetConditions;
+
+typedef struct {
+    double sendAt;
+    NetAddress to;
+    uint16_t size;
+    uint8_t data[NET_MAX_PACKET];
+} NetDelayed;
+
+typedef struct {
+    intptr_t handle;
+    NetConditions conditions;
+    SimRng rng;
+    NetDelayed queue[NET_DELAY_QUEUE];
+    int queueCount;
+    uint64_t bytesSent, bytesReceived;
+    uint32_t packetsSent, packetsReceived, packetsLost;
+} NetSocket;
+
+// ------------------- Statistics -------------------
+#define NET_RTT_SAMPLES 64
+
+typedef struct {
+    uint32_t snapshots, fullSnapshots;
+    uint64_t snapshotBytes;         // on the wire, headers included
+    uint32_t rollbacks;             // snapshots that disagreed with the prediction
+    uint32_t resimulatedTicks;
+    float rttMs[NET_RTT_SAMPLES];   // ring of recent round trips
+    int rttCount;
+} NetStats;
+
+float NetRttPercentile(const NetStats *stats, float p);   // p in 0..1, 0 without samples
+
+// ------------------- Server -------------------
+typedef struct {
+    uint32_t seq;
+    uint32_t tick;
+    uint16_t hole;
+    uint8_t team;
+} NetPendingHit;
+
+typedef struct {
+    bool active;
+    NetAddress address;
+    double lastHeard;
+    uint32_t ackMatch, ackTick;     // newest snapshot the client has
+    uint32_t queuedSeq;             // newest hit queued
+    uint32_t appliedSeq;            // newest hit applied (acknowledged in snapshots)
+    double pingTime, pingReceived;  // echoed back for RTT
+} NetPeer;
+
+typedef struct {
+    NetSocket socket;
+    int teamCount;
+    NetPeer peers[SIM_MAX_TEAMS];   // by team
+
+    Match match;
+    uint32_t matchId;
+    bool running;
+    double clock;                   // time at which match.tick ended
+    double nextSnapshot;
+    double restartAt;
+
+    NetPendingHit hits[256];
+    int hitCount;
+
+    struct { uint32_t matchId, tick; uint16_t size; uint8_t data[NET_MAX_SNAPSHOT]; } ring[NET_SNAPSHOT_RING];
+    int ringHead;
+} NetServer;
+
+bool NetServerStart(NetServer *server, uint16_t port, int teamCount, const NetConditions *conditions);
+void NetServerUpdate(NetServer *server, double now);    // receive, step, send snapshots
+void NetServerStop(NetServer *server);
+
+// ------------------- Client -------------------
+typedef struct {
+    uint32_t seq;
+    uint32_t tick;          // tick whose step applies it
+    uint16_t hole;
+    bool applied;           // already part of the predicted state
+} NetHit;
+
+typedef struct {
+    NetSocket socket;
+    NetAddress server;
+    Match *match;                   // the predicted match, owned by the caller
+    int team;                       // -1 until the server assigns one
+    int wantTeam;
+    bool live;                      // a server match is running here
+    uint32_t matchId;
+    double clock;
+    double lastSend, lastHello;
+
+    // Newest authoritative state
+    uint32_t authTick;
+    double authReceived;
+
+    NetHit pending[NET_MAX_PENDING];
+    int pendingCount;
+    uint32_t nextSeq;
+    bool sendNow;
+
+    struct { uint32_t tick; uint16_t size; uint8_t data[NET_MAX_SNAPSHOT]; } ring[NET_CLIENT_RING];
+    int ringHead;
+    uint32_t historyTick[NET_HISTORY];
+    uint64_t historyHash[NET_HISTORY];
+
+    NetStats stats;
+} NetClient;
+
+bool NetClientConnect(NetClient *client, Match *match, const char *host, uint16_t port, int team, const NetConditions *conditions);
+void NetClientHit(NetClient *client, int hole);     // predicted now, sent with the next update
+void NetClientUpdate(NetClient *client, double now);
+void NetClientDisconnect(NetClient *client);
+
+#endif
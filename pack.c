@@ -0,0 +1,171 @@
+#include "pack.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// No raylib here, so the platform headers can't clash with its names
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+    #define PACK_MMAP 1
+#elif defined(__unix__) || defined(__APPLE__)
+    #if !defined(__EMSCRIPTEN__)
+        #include <fcntl.h>
+        #include <sys/mman.h>
+        #include <sys/stat.h>
+        #include <unistd.h>
+        #define PACK_MMAP 1
+    #endif
+#endif
+
+// ------------------- Mapping -------------------
+#if defined(PACK_MMAP) && defined(_WIN32)
+static bool MapFile(Pack *pack, const char *path){
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    HANDLE mapping = NULL;
+    if(GetFileSizeEx(file, &size)) mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if(!mapping) return false;
+    pack->base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if(!pack->base){ CloseHandle(mapping); return false; }
+    pack->size = (size_t)size.QuadPart;
+    pack->handle = mapping;
+    pack->mapped = true;
+    return true;
+}
+
+static void UnmapFile(Pack *pack){
+    UnmapViewOfFile(pack->base);
+    CloseHandle(pack->handle);
+}
+#elif defined(PACK_MMAP)
+static bool MapFile(Pack *pack, const char *path){
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) return false;
+    struct stat st;
+    void *base = MAP_FAILED;
+    if(fstat(fd, &st) == 0 && st.st_size > 0) base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(base == MAP_FAILED) return false;
+    pack->base = base;
+    pack->size = (size_t)st.st_size;
+    pack->mapped = true;
+    return true;
+}
+
+static void UnmapFile(Pack *pack){
+    munmap((void *)pack->base, pack->size);
+}
+#endif
+
+// Fallback (web): read it all in
+static bool ReadWholeFile(Pack *pack, const char *path){
+    FILE *f = fopen(path, "rb");
+    if(!f) return false;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *data = (size > 0) ? malloc((size_t)size) : NULL;
+    bool ok = data && fread(data, 1, (size_t)size, f) == (size_t)size;
+    fclose(f);
+    if(!ok){ free(data); return false; }
+    pack->base = data;
+    pack->size = (size_t)size;
+    pack->mapped = false;
+    return true;
+}
+
+// ------------------- Validation -------------------
+// Bits per pixel of raylib's uncompressed PixelFormat values (1..13); the
+// packer never writes the compressed ones
+static const uint8_t pixelBits[] = { 0, 8, 16, 16, 24, 16, 16, 32, 32, 96, 128, 16, 48, 64 };
+
+// Bytes the entry's params say its payload holds; UINT64_MAX if they make no sense
+static uint64_t PayloadSize(const PackEntry *e){
+    switch(e->kind){
+        case PACK_TEXTURE: {
+            uint64_t w = e->params[0], h = e->params[1], size = 0;
+            uint32_t mips = e->params[2], format = e->params[3];
+            if(!w || !h || w > 16384 || h > 16384 || !mips || mips > 15 || !format
+               || format >= sizeof(pixelBits)) return UINT64_MAX;
+            for(uint32_t i=0;i<mips;i++){
+                size += w*h*pixelBits[format]/8;
+                w = (w > 1) ? w/2 : 1;
+                h = (h > 1) ? h/2 : 1;
+            }
+            return size;
+        }
+        case PACK_WAVE: {
+            uint32_t bits = PACK_WAVE_BITS(e), channels = PACK_WAVE_CHANNELS(e);
+            if((bits != 8 && bits != 16 && bits != 32) || !channels || channels > 8) return UINT64_MAX;
+            return (uint64_t)PACK_WAVE_FRAMES(e)*channels*(bits/8);
+        }
+        case PACK_STREAM:
+            return e->size;
+        case PACK_FONT:
+            return (uint64_t)e->params[1]*sizeof(PackGlyph);
+        case PACK_ATLAS:
+            if(!e->params[1]) return UINT64_MAX;     // no pages; the loader caps the count
+            return (uint64_t)e->params[0]*sizeof(PackSprite);
+        default:
+            return UINT64_MAX;
+    }
+}
+
+// ------------------- Open / Close -------------------
+bool PackOpen(Pack *pack, const char *path){
+    memset(pack, 0, sizeof(*pack));
+    bool ok = false;
+#if defined(PACK_MMAP)
+    ok = MapFile(pack, path);
+#endif
+    if(!ok) ok = ReadWholeFile(pack, path);
+    if(!ok) return false;
+
+    // Validate the header and every entry once, so lookups can trust them
+    const PackHeader *h = (const PackHeader *)pack->base;
+    bool valid = pack->size >= sizeof(PackHeader) && memcmp(h->magic, PACK_MAGIC, 4) == 0 && h->version == PACK_VERSION
+              && (uint64_t)h->entryCount*sizeof(PackEntry) <= pack->size - sizeof(PackHeader);
+    if(valid){
+        const PackEntry *e = (const PackEntry *)(pack->base + sizeof(PackHeader));
+        for(uint32_t i=0;i<h->entryCount && valid;i++){
+            valid = e[i].offset <= pack->size && e[i].size <= pack->size - e[i].offset
+                 && memchr(e[i].name, 0, PACK_NAME_MAX) != NULL && PayloadSize(&e[i]) == e[i].size;
+            if(!valid) fprintf(stderr, "PACK: entry %u (%.*s) has a bad size or parameters\n", i, PACK_NAME_MAX, e[i].name);
+        }
+        pack->header = h;
+        pack->entries = e;
+    }
+    if(!valid){
+        fprintf(stderr, "PACK: %s is not a valid v%d pack\n", path, PACK_VERSION);
+        PackClose(pack);
+        return false;
+    }
+    return true;
+}
+
+void PackClose(Pack *pack){
+    if(!pack->base) return;
+#if defined(PACK_MMAP)
+    if(pack->mapped) UnmapFile(pack);
+    else free((void *)pack->base);
+#else
+    free((void *)pack->base);
+#endif
+    memset(pack, 0, sizeof(*pack));
+}
+
+// ------------------- Lookup -------------------
+const PackEntry *PackFind(const Pack *pack, const char *name){
+    if(!pack || !pack->header) return NULL;
+    for(uint32_t i=0;i<pack->header->entryCount;i++){
+        if(strcmp(pack->entries[i].name, name) == 0) return &pack->entries[i];
+    }
+    return NULL;
+}
+
+const void *PackData(const Pack *pack, const PackEntry *entry){
+    return pack->base + entry->offset;
+}
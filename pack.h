@@ -0,0 +1,86 @@
+#ifndef PACK_H
+#define PACK_H
+
+// Asset pack: one file with a header index and GPU/audio-ready payloads.
+// Textures are raw pixels in a raylib PixelFormat (mip chain appended), sound
+// effects are raw PCM, and only streamed music stays compressed. The runtime
+// maps the file and hands payload pointers straight to the upload calls.
+//
+// Layout (little-endian):
+//   PackHeader | PackEntry[entryCount] | payloads, each PACK_ALIGN-aligned
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PACK_MAGIC "WAMP"
+#define PACK_VERSION 1
+#define PACK_ALIGN 64
+#define PACK_NAME_MAX 48
+
+typedef enum {
+    PACK_TEXTURE = 1,   // w/h/mipmaps/format; payload = pixels of every mip level
+    PACK_WAVE = 2,      // sampleRate/sampleSize/channels/frameCount; payload = interleaved PCM
+    PACK_STREAM = 3,    // payload = the original compressed file, name keeps its extension
+    PACK_FONT = 4,      // payload = PackGlyph[glyphCount]; the glyph atlas is "<name>.tex"
+    PACK_ATLAS = 5      // payload = PackSprite[spriteCount]; pages are "atlas.page<N>"
+} PackKind;
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+} PackHeader;
+
+typedef struct {
+    char name[PACK_NAME_MAX];   // source path, e.g. "assets/visual/menu_background.png"
+    uint32_t kind;
+    uint32_t params[5];         // meaning depends on kind, see the accessors below
+    uint64_t offset;            // from the start of the file
+    uint64_t size;
+} PackEntry;
+
+// PACK_TEXTURE
+#define PACK_TEX_WIDTH(e)       ((int)(e)->params[0])
+#define PACK_TEX_HEIGHT(e)      ((int)(e)->params[1])
+#define PACK_TEX_MIPMAPS(e)     ((int)(e)->params[2])
+#define PACK_TEX_FORMAT(e)      ((int)(e)->params[3])
+// PACK_WAVE
+#define PACK_WAVE_RATE(e)       ((e)->params[0])
+#define PACK_WAVE_BITS(e)       ((e)->params[1])
+#define PACK_WAVE_CHANNELS(e)   ((e)->params[2])
+#define PACK_WAVE_FRAMES(e)     ((e)->params[3])
+// PACK_FONT
+#define PACK_FONT_SIZE(e)       ((int)(e)->params[0])
+#define PACK_FONT_GLYPHS(e)     ((int)(e)->params[1])
+#define PACK_FONT_PADDING(e)    ((int)(e)->params[2])
+// PACK_ATLAS
+#define PACK_ATLAS_SPRITES(e)   ((int)(e)->params[0])
+#define PACK_ATLAS_PAGES(e)     ((int)(e)->params[1])
+
+typedef struct {
+    int32_t value, offsetX, offsetY, advanceX;
+    float x, y, width, height;          // rect in the glyph atlas
+} PackGlyph;
+
+typedef struct {
+    int32_t page;
+    float x, y, width, height;
+} PackSprite;
+
+typedef struct {
+    const uint8_t *base;
+    size_t size;
+    const PackHeader *header;
+    const PackEntry *entries;
+    bool mapped;                // memory-mapped (native) or read into memory (web)
+    void *handle;               // platform mapping handle
+} Pack;
+
+bool PackOpen(Pack *pack, const char *path);
+void PackClose(Pack *pack);
+const PackEntry *PackFind(const Pack *pack, const char *name);
+const void *PackData(const Pack *pack, const PackEntry *entry);
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+// Hit effects. Each emitter owns a fixed pool in structure-of-arrays layout,
+// allocated once. Live particles stay packed at the front (dead ones are
+// swapped out), so an update touches only what is on screen and is a few
+// straight loops over float arrays the compiler vectorizes. Drawing is one
+// quad batch per emitter, with a single texture.
+
+#include "raylib.h"
+#include <stdint.h>
+
+// How an emitter's particles look and move
+typedef struct {
+    float speedMin, speedMax;   // px/s, in a cone around straight up
+    float spread;               // cone half-angle, radians (PI: all directions)
+    float sizeMin, sizeMax;     // half-size in px at birth; shrinks to half by death
+    float lifeMin, lifeMax;     // seconds
+    float gravity;              // px/s^2, down
+    float drag;                 // fraction of velocity lost per second
+    Color start, end;           // tint at birth and at death (fading out)
+} ParticleStyle;
+
+typedef struct {
+    ParticleStyle style;
+    int capacity, count;
+    float *x, *y, *vx, *vy;
+    float *age, *invLife, *size;
+    unsigned dropped;           // spawns that found the pool full
+    uint32_t rng;
+} ParticleEmitter;
+
+bool ParticleEmitterInit(ParticleEmitter *e, ParticleStyle style, int capacity);   // false: no memory, capacity 0
+void ParticleEmitterFree(ParticleEmitter *e);
+void ParticleBurst(ParticleEmitter *e, float x, float y, int count);
+void ParticlesUpdate(ParticleEmitter *e, float dt);
+void ParticlesClear(ParticleEmitter *e);
+// source: the texture region to draw (e.g. a sprite in an atlas page)
+void ParticlesDraw(const ParticleEmitter *e, Texture2D texture, Rectangle source);
+
+#endif
@@ -0,0 +1,125 @@
+#include "profiler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *const phaseNames[PROF_PHASE_COUNT] = { "loader", "music", "update", "draw", "present", "input" };
+
+typedef struct {
+    float frameMs;
+    float phaseMs[PROF_PHASE_COUNT];
+    int drawCalls;
+    int sounds;
+} ProfSample;
+
+// ------------------- Current Frame -------------------
+static double phaseTime[PROF_PHASE_COUNT];
+static int soundCount = 0;
+static double lastFrameEnd = -1.0;
+
+void ProfAdd(ProfPhase phase, double seconds){
+    phaseTime[phase] += seconds;
+}
+
+void PlaySoundCounted(Sound sound){
+    PlaySound(sound);
+    soundCount++;
+}
+
+// ------------------- History & CSV -------------------
+static ProfSample history[PROF_WINDOW];
+static int historyHead = 0, historyCount = 0;
+static long frameIndex = 0;
+static FILE *csv = NULL;
+
+bool ProfOpenCsv(const char *path){
+    csv = (strcmp(path, "-") == 0) ? stdout : fopen(path, "w");
+    if(!csv){
+        TraceLog(LOG_WARNING, "PROFILER: cannot open %s", path);
+        return false;
+    }
+    fprintf(csv, "frame,frame_ms");
+    for(int i=0;i<PROF_PHASE_COUNT;i++) fprintf(csv, ",%s_ms", phaseNames[i]);
+    fprintf(csv, ",draw_calls,sounds\n");
+    return true;
+}
+
+void ProfCloseCsv(void){
+    if(csv && csv != stdout) fclose(csv);
+    csv = NULL;
+}
+
+void ProfFrameEnd(int drawCalls){
+    double now = GetTime();
+    ProfSample s = {0};
+    s.frameMs = (lastFrameEnd < 0.0) ? 0.0f : (float)((now - lastFrameEnd)*1000.0);
+    for(int i=0;i<PROF_PHASE_COUNT;i++) s.phaseMs[i] = (float)(phaseTime[i]*1000.0);
+    s.drawCalls = drawCalls;
+    s.sounds = soundCount;
+    lastFrameEnd = now;
+
+    history[historyHead] = s;
+    historyHead = (historyHead + 1) % PROF_WINDOW;
+    if(historyCount < PROF_WINDOW) historyCount++;
+
+    if(csv){
+        fprintf(csv, "%ld,%.3f", frameIndex, s.frameMs);
+        for(int i=0;i<PROF_PHASE_COUNT;i++) fprintf(csv, ",%.3f", s.phaseMs[i]);
+        fprintf(csv, ",%d,%d\n", s.drawCalls, s.sounds);
+    }
+    frameIndex++;
+
+    memset(phaseTime, 0, sizeof(phaseTime));
+    soundCount = 0;
+}
+
+// ------------------- Overlay -------------------
+static int CompareFloat(const void *a, const void *b){
+    float x = *(const float *)a, y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+// i = 0 is the oldest frame in the window
+static const ProfSample *HistoryAt(int i){
+    return &history[(historyHead - historyCount + i + PROF_WINDOW) % PROF_WINDOW];
+}
+
+void ProfDrawOverlay(int x, int y){
+    if(historyCount == 0) return;
+    const int width = PROF_WINDOW*2, graphHeight = 100;
+    const float msScale = graphHeight/50.0f;    // graph tops out at 50 ms
+
+    float sorted[PROF_WINDOW];
+    float phaseAvg[PROF_PHASE_COUNT] = {0};
+    for(int i=0;i<historyCount;i++){
+        const ProfSample *s = HistoryAt(i);
+        sorted[i] = s->frameMs;
+        for(int p=0;p<PROF_PHASE_COUNT;p++) phaseAvg[p] += s->phaseMs[p]/historyCount;
+    }
+    qsort(sorted, historyCount, sizeof(float), CompareFloat);
+    const ProfSample *last = HistoryAt(historyCount - 1);
+
+    DrawRectangle(x, y, width + 20, graphHeight + 122, Fade(BLACK, 0.7f));
+    x += 10; y += 10;
+    DrawText(TextFormat("frame p50 %.2f  p95 %.2f  p99 %.2f ms", sorted[historyCount/2],
+        sorted[historyCount*95/100], sorted[historyCount*99/100]), x, y, 20, LIME);
+    y += 26;
+    for(int p=0;p<PROF_PHASE_COUNT;p++){
+        DrawText(TextFormat("%-8s %6.2f ms", phaseNames[p], phaseAvg[p]), x + (p%3)*160, y + (p/3)*22, 18, WHITE);
+    }
+    y += 48;
+    DrawText(TextFormat("draw calls %d   PlaySound %d", last->drawCalls, last->sounds), x, y, 18, WHITE);
+    y += 28;
+
+    // Frame-time graph, newest on the right; lines at 16.7 and 33.3 ms
+    int base = y + graphHeight;
+    for(int i=0;i<historyCount;i++){
+        const ProfSample *s = HistoryAt(i);
+        float h = s->frameMs*msScale;
+        if(h > graphHeight) h = (float)graphHeight;
+        Color c = (s->frameMs > 1000.0f/30) ? RED : (s->frameMs > 1000.0f/60 + 1.0f) ? YELLOW : GREEN;
+        DrawRectangle(x + (PROF_WINDOW - historyCount + i)*2, base - (int)h, 2, (int)h, c);
+    }
+    DrawLine(x, base - (int)(16.7f*msScale), x + width, base - (int)(16.7f*msScale), GRAY);
+    DrawLine(x, base - (int)(33.3f*msScale), x + width, base - (int)(33.3f*msScale), GRAY);
+}
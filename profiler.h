@@ -0,0 +1,27 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// Frame profiler. Each phase of the main loop is timed with PROF_SCOPE; one
+// sample per frame goes into a rolling window for the overlay and, with
+// ProfOpenCsv(), into a CSV file for comparing builds/machines.
+
+#include "raylib.h"
+
+#define PROF_WINDOW 240     // frames kept for percentiles and the graph
+
+typedef enum { PROF_LOADER, PROF_MUSIC, PROF_UPDATE, PROF_DRAW, PROF_PRESENT, PROF_INPUT, PROF_PHASE_COUNT } ProfPhase;
+
+// Times the statement/block that follows:  PROF_SCOPE(PROF_DRAW) DrawGame(pos);
+#define PROF_SCOPE(phase) \
+    for(double profStart_ = GetTime(), profOnce_ = 1; profOnce_; profOnce_ = 0, ProfAdd(phase, GetTime() - profStart_))
+
+void ProfAdd(ProfPhase phase, double seconds);
+void ProfFrameEnd(int drawCalls);           // once per loop iteration
+void PlaySoundCounted(Sound sound);         // PlaySound() plus a per-frame count
+
+bool ProfOpenCsv(const char *path);         // "-" writes to stdout (the browser console on the web)
+void ProfCloseCsv(void);
+
+void ProfDrawOverlay(int x, int y);
+
+#endif
@@ -0,0 +1,122 @@
+#include "render.h"
+#include "rlgl.h"
+#include <math.h>
+
+#define SCALE_QUANTUM 0.02f         // smaller changes aren't worth a visible jump
+#define SCALE_MAX_DROP 0.15f        // per change: fall fast when over budget...
+#define SCALE_MAX_RISE 0.05f        // ...climb back slowly
+#define SCALE_INTERVAL 0.5          // seconds between changes, so each one is measured first
+
+RenderScaler renderScaler;
+
+static RenderTexture2D target;
+static int virtualWidth, virtualHeight;
+static int drawnWidth, drawnHeight;     // pixels of the target used this frame
+static Rectangle dest;                  // where the target lands in the window
+static double frameBudget, lastChange;
+static bool composing;                  // between RenderBegin and RenderEnd
+static bool retained;                   // the target holds retainedKey's image at retainedScale
+static unsigned retainedKey;
+static float retainedScale;
+
+// No point rendering more pixels than the window shows. A fixed scale follows
+// the window both ways; the controller only has its ceiling lowered or raised.
+static void FitWindow(void){
+    RenderScaler *s = &renderScaler;
+    float fit = fminf((float)GetScreenWidth()/virtualWidth, (float)GetScreenHeight()/virtualHeight);
+    s->windowScale = fminf(s->maxScale, fit);
+    if(!s->automatic || s->scale > s->windowScale) s->scale = s->windowScale;
+}
+
+void RenderInit(int width, int height, float minScale, float maxScale, double budget){
+    virtualWidth = width;
+    virtualHeight = height;
+    frameBudget = budget;
+
+    if(minScale > maxScale) minScale = maxScale;
+    renderScaler = (RenderScaler){ .scale = maxScale, .minScale = minScale, .maxScale = maxScale, .automatic = minScale < maxScale };
+    FitWindow();
+
+    target = LoadRenderTexture((int)ceilf(width*maxScale), (int)ceilf(height*maxScale));
+    SetTextureFilter(target.texture, TEXTURE_FILTER_BILINEAR);
+    TraceLog(LOG_INFO, "RENDER: %dx%d target, scale %.2f-%.2f%s", target.texture.width, target.texture.height,
+             minScale, maxScale, renderScaler.automatic ? "" : " (fixed)");
+}
+
+void RenderShutdown(void){
+    UnloadRenderTexture(target);
+}
+
+// ------------------- Frame -------------------
+void RenderBegin(void){
+    composing = true;
+    retained = false;
+    drawnWidth = (int)(virtualWidth*renderScaler.scale + 0.5f);
+    drawnHeight = (int)(virtualHeight*renderScaler.scale + 0.5f);
+    BeginTextureMode(target);
+    ClearBackground(BLACK);
+    // Virtual coordinates onto the used corner only (the GL origin, bottom-left)
+    rlViewport(0, 0, drawnWidth, drawnHeight);
+    rlMatrixMode(RL_PROJECTION);
+    rlLoadIdentity();
+    rlOrtho(0, virtualWidth, virtualHeight, 0, 0.0, 1.0);
+    rlMatrixMode(RL_MODELVIEW);
+    rlLoadIdentity();
+}
+
+bool RenderBeginRetained(unsigned key){
+    if(retained && key == retainedKey && renderScaler.scale == retainedScale) return false;
+    RenderBegin();
+    retained = true;
+    retainedKey = key;
+    retainedScale = renderScaler.scale;
+    return true;
+}
+
+void RenderEnd(void){
+    if(composing) EndTextureMode();
+    composing = false;
+
+    if(IsWindowResized()) FitWindow();
+    float k = fminf((float)GetScreenWidth()/virtualWidth, (float)GetScreenHeight()/virtualHeight);
+    dest = (Rectangle){ (GetScreenWidth() - virtualWidth*k)/2, (GetScreenHeight() - virtualHeight*k)/2, virtualWidth*k, virtualHeight*k };
+    ClearBackground(BLACK);
+    // Render textures are stored bottom-up: negative height flips the used rows
+    DrawTexturePro(target.texture, (Rectangle){ 0, 0, drawnWidth, -drawnHeight }, dest, (Vector2){0, 0}, 0.0f, WHITE);
+
+    SetMouseOffset(-(int)dest.x, -(int)dest.y);
+    SetMouseScale(virtualWidth/dest.width, virtualHeight/dest.height);
+}
+
+void RenderBeginOverlay(void){
+    BeginMode2D((Camera2D){ .offset = { dest.x, dest.y }, .zoom = dest.width/virtualWidth });
+}
+
+void RenderEndOverlay(void){
+    EndMode2D();
+}
+
+// ------------------- Controller -------------------
+// Fill cost goes with pixel count (scale squared), so a frame at cost c and
+// scale s lands near the target at s*sqrt(target/c). It aims for 80% of the
+// budget and only moves when outside 65-95%, which keeps it from hunting.
+void RenderFrameCost(double seconds){
+    RenderScaler *s = &renderScaler;
+    float ms = (float)(seconds*1000.0);
+    s->frameMs = (s->frameMs > 0) ? s->frameMs*0.9f + ms*0.1f : ms;
+    if(!s->automatic) return;
+
+    double now = GetTime();
+    if(now - lastChange < SCALE_INTERVAL) return;
+    float budgetMs = (float)(frameBudget*1000.0);
+    if(s->frameMs > budgetMs*0.65f && s->frameMs < budgetMs*0.95f) return;
+
+    float want = s->scale*sqrtf(budgetMs*0.8f/s->frameMs);
+    want = fmaxf(want, s->scale - SCALE_MAX_DROP);
+    want = fminf(want, s->scale + SCALE_MAX_RISE);
+    want = fminf(fmaxf(want, s->minScale), s->windowScale);
+    if(fabsf(want - s->scale) < SCALE_QUANTUM) return;
+    s->scale = want;
+    s->changes++;
+    lastChange = now;
+}
@@ -0,0 +1,43 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+// Dynamic resolution. The game draws in a fixed virtual coordinate space
+// (SCREEN_WIDTH x SCREEN_HEIGHT) into an offscreen target; only scale*size of
+// it is rendered, then upscaled and letterboxed to the window. A controller
+// moves the scale with the measured frame cost to stay inside the frame budget.
+// Mouse positions are mapped back to virtual coordinates, so input code and the
+// board never see the window size.
+
+#include "raylib.h"
+
+typedef struct {
+    float scale;            // of the virtual size, per axis
+    float minScale, maxScale;
+    float windowScale;      // maxScale capped to what the window shows; the scale stays under it
+    bool automatic;         // controller on (min < max)
+    float frameMs;          // smoothed frame cost the controller sees
+    int changes;
+} RenderScaler;
+
+extern RenderScaler renderScaler;
+
+// After InitWindow(). The target is sized for maxScale, so the window can grow
+// up to that; the scale in use is also capped to what the window shows
+// (windowScale), refreshed when it's resized.
+void RenderInit(int virtualWidth, int virtualHeight, float minScale, float maxScale, double frameBudget);
+void RenderShutdown(void);
+
+// Inside BeginDrawing()/EndDrawing()
+void RenderBegin(void);         // draws go to the target, in virtual coordinates
+void RenderEnd(void);           // upscales the target to the window
+// Retained screens: the target keeps its last image. Composes (as RenderBegin) and
+// returns true when key, the scale or the target changed since it was drawn with
+// this key; otherwise returns false, the caller draws nothing and RenderEnd
+// presents the kept image.
+bool RenderBeginRetained(unsigned key);
+void RenderBeginOverlay(void);  // virtual coordinates straight onto the window, at full resolution
+void RenderEndOverlay(void);
+
+void RenderFrameCost(double seconds);   // once a frame: time spent, not counting the frame-cap wait
+
+#endif
@@ -0,0 +1,356 @@
+#include "replay.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ------------------- Byte Buffers -------------------
+typedef struct { uint8_t *data; size_t size, capacity; bool ok; } Buffer;
+typedef struct { const uint8_t *p, *end; bool ok; } Reader;
+
+static void PutBytes(Buffer *b, const void *data, size_t size){
+    if(!b->ok) return;
+    if(b->size + size > b->capacity){
+        size_t capacity = b->capacity ? b->capacity*2 : 4096;
+        while(capacity < b->size + size) capacity *= 2;
+        uint8_t *grown = realloc(b->data, capacity);
+        if(!grown){ b->ok = false; return; }
+        b->data = grown;
+        b->capacity = capacity;
+    }
+    memcpy(b->data + b->size, data, size);
+    b->size += size;
+}
+
+static void Put(Buffer *b, uint64_t v, int bytes){
+    uint8_t le[8];
+    for(int i=0;i<bytes;i++) le[i] = (uint8_t)(v >> (8*i));
+    PutBytes(b, le, (size_t)bytes);
+}
+
+static void PutF32(Buffer *b, float f){
+    uint32_t v;
+    memcpy(&v, &f, 4);
+    Put(b, v, 4);
+}
+
+static void PutVarint(Buffer *b, uint32_t v){
+    while(v >= 0x80){ Put(b, (v & 0x7F) | 0x80, 1); v >>= 7; }
+    Put(b, v, 1);
+}
+
+static uint64_t Get(Reader *r, int bytes){
+    if(r->end - r->p < bytes){ r->ok = false; r->p = r->end; return 0; }
+    uint64_t v = 0;
+    for(int i=0;i<bytes;i++) v |= (uint64_t)*r->p++ << (8*i);
+    return v;
+}
+
+static float GetF32(Reader *r){
+    uint32_t v = (uint32_t)Get(r, 4);
+    float f;
+    memcpy(&f, &v, 4);
+    return f;
+}
+
+static uint32_t GetVarint(Reader *r){
+    uint32_t v = 0;
+    for(int shift=0;shift<32;shift+=7){
+        uint32_t b = (uint32_t)Get(r, 1);
+        v |= (b & 0x7F) << shift;
+        if(!(b & 0x80)) return v;
+    }
+    r->ok = false;
+    return 0;
+}
+
+static uint8_t *ReadWholeFile(const char *path, size_t *size){
+    FILE *f = fopen(path, "rb");
+    if(!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long length = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *data = (length > 0) ? malloc((size_t)length) : NULL;
+    if(data && fread(data, 1, (size_t)length, f) != (size_t)length){ free(data); data = NULL; }
+    fclose(f);
+    *size = (size_t)length;
+    return data;
+}
+
+// Readers never see a half-written file: write aside, then swap it in
+static bool WriteFileAtomic(const char *path, const uint8_t *data, size_t size){
+    char tmp[512];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE *f = fopen(tmp, "wb");
+    if(!f) return false;
+    bool ok = fwrite(data, 1, size, f) == size;
+    ok = (fclose(f) == 0) && ok;
+#if defined(_WIN32)
+    if(ok) remove(path);    // rename() won't replace a file here
+#endif
+    if(ok) ok = rename(tmp, path) == 0;
+    if(!ok) remove(tmp);
+    return ok;
+}
+
+static uint64_t HashMatch(const Match *match){
+    size_t size = SimSnapshotSize(match);
+    uint8_t *data = malloc(size);
+    if(!data) return 0;
+    SimSave(match, data, size);
+    uint64_t hash = SimHash(data, size);
+    free(data);
+    return hash;
+}
+
+// ------------------- Recording -------------------
+void ReplayBegin(Replay *replay, const Match *match, uint64_t seed){
+    replay->seed = seed;
+    replay->teamCount = match->teamCount;
+    replay->hammerSize = match->hammerSize;
+    replay->board = match->board ? *match->board : simDefaultBoard;
+    replay->hitCount = 0;
+    replay->finished = false;
+}
+
+void ReplayRecordHit(Replay *replay, const Match *match, int hole, int team){
+    if(replay->hitCount == replay->hitCapacity){
+        int capacity = replay->hitCapacity ? replay->hitCapacity*2 : 256;
+        ReplayHit *grown = realloc(replay->hits, (size_t)capacity*sizeof(ReplayHit));
+        if(!grown) return;
+        replay->hits = grown;
+        replay->hitCapacity = capacity;
+    }
+    replay->hits[replay->hitCount++] = (ReplayHit){ match->tick + 1, (uint16_t)hole, (uint8_t)team };
+}
+
+void ReplayEnd(Replay *replay, const Match *match){
+    replay->finished = true;
+    replay->finalTick = match->tick;
+    for(int t=0;t<SIM_MAX_TEAMS;t++) replay->finalScores[t] = (t < match->teamCount) ? match->scores[t] : 0;
+    replay->finalHash = HashMatch(match);
+}
+
+void ReplayFree(Replay *replay){
+    free(replay->hits);
+    replay->hits = NULL;
+    replay->hitCount = replay->hitCapacity = 0;
+}
+
+// ------------------- Replay Files -------------------
+// "WAMR", version, seed, teams, hammer size, board, then hits as
+// [tick delta varint][hole varint][team], then the result
+bool ReplaySave(const Replay *replay, const char *path){
+    Buffer b = { NULL, 0, 0, true };
+    PutBytes(&b, "WAMR", 4);
+    Put(&b, REPLAY_VERSION, 1);
+    Put(&b, replay->seed, 8);
+    Put(&b, (uint32_t)replay->teamCount, 1);
+    PutF32(&b, replay->hammerSize.x);
+    PutF32(&b, replay->hammerSize.y);
+    PutF32(&b, replay->board.spawnMeanIdle);
+    Put(&b, (uint32_t)replay->board.holeCount, 2);
+    for(int i=0;i<replay->board.holeCount;i++){
+        PutF32(&b, replay->board.pos[i].x);
+        PutF32(&b, replay->board.pos[i].y);
+    }
+
+    Put(&b, (uint32_t)replay->hitCount, 4);
+    uint32_t lastTick = 0;
+    for(int i=0;i<replay->hitCount;i++){
+        const ReplayHit *h = &replay->hits[i];
+        PutVarint(&b, h->tick - lastTick);
+        PutVarint(&b, h->hole);
+        Put(&b, h->team, 1);
+        lastTick = h->tick;
+    }
+
+    Put(&b, replay->finished, 1);
+    Put(&b, replay->finalTick, 4);
+    for(int t=0;t<replay->teamCount;t++) Put(&b, (uint32_t)replay->finalScores[t], 4);
+    Put(&b, replay->finalHash, 8);
+
+    bool ok = b.ok && WriteFileAtomic(path, b.data, b.size);
+    if(!ok) fprintf(stderr, "REPLAY: cannot write %s\n", path);
+    free(b.data);
+    return ok;
+}
+
+bool ReplayLoad(Replay *replay, const char *path){
+    size_t size = 0;
+    uint8_t *data = ReadWholeFile(path, &size);
+    if(!data){
+        fprintf(stderr, "REPLAY: cannot open %s\n", path);
+        return false;
+    }
+    Reader r = { data, data + size, true };
+    Replay loaded = {0};
+    bool ok = size >= 5 && !memcmp(data, "WAMR", 4);
+    if(ok) r.p += 4;
+    ok = ok && Get(&r, 1) == REPLAY_VERSION;
+
+    if(ok){
+        loaded.seed = Get(&r, 8);
+        loaded.teamCount = (int)Get(&r, 1);
+        loaded.hammerSize.x = GetF32(&r);
+        loaded.hammerSize.y = GetF32(&r);
+        loaded.board.spawnMeanIdle = GetF32(&r);
+        loaded.board.holeCount = (int)Get(&r, 2);
+        ok = loaded.teamCount >= 1 && loaded.teamCount <= SIM_MAX_TEAMS
+          && loaded.board.holeCount >= 1 && loaded.board.holeCount <= SIM_MAX_HOLES;
+    }
+    for(int i=0;ok && i<loaded.board.holeCount;i++){
+        loaded.board.pos[i].x = GetF32(&r);
+        loaded.board.pos[i].y = GetF32(&r);
+    }
+
+    uint32_t hitCount = ok ? (uint32_t)Get(&r, 4) : 0;
+    ok = ok && r.ok && hitCount <= (uint32_t)(r.end - r.p)/3;     // at least 3 bytes a hit
+    if(ok && hitCount){
+        loaded.hits = malloc(hitCount*sizeof(ReplayHit));
+        loaded.hitCapacity = (int)hitCount;
+        ok = loaded.hits != NULL;
+    }
+    uint32_t tick = 0;
+    for(uint32_t i=0;ok && i<hitCount;i++){
+        tick += GetVarint(&r);
+        uint32_t hole = GetVarint(&r);
+        uint32_t team = (uint32_t)Get(&r, 1);
+        ok = r.ok && hole < (uint32_t)loaded.board.holeCount && team < (uint32_t)loaded.teamCount;
+        loaded.hits[loaded.hitCount++] = (ReplayHit){ tick, (uint16_t)hole, (uint8_t)team };
+    }
+
+    if(ok){
+        loaded.finished = Get(&r, 1) != 0;
+        loaded.finalTick = (uint32_t)Get(&r, 4);
+        for(int t=0;t<loaded.teamCount;t++) loaded.finalScores[t] = (int)(uint32_t)Get(&r, 4);
+        loaded.finalHash = Get(&r, 8);
+        ok = r.ok && r.p == r.end;
+    }
+    free(data);
+
+    if(!ok){
+        fprintf(stderr, "REPLAY: %s is not a valid replay\n", path);
+        ReplayFree(&loaded);
+        return false;
+    }
+    ReplayFree(replay);
+    *replay = loaded;
+    return true;
+}
+
+// ------------------- Playback -------------------
+static void Restart(ReplayPlayer *player){
+    Match *m = player->match;
+    m->board = &player->replay->board;
+    m->teamCount = player->replay->teamCount;
+    m->hammerSize = player->replay->hammerSize;
+    SimInit(m, player->replay->seed);
+    player->nextHit = 0;
+}
+
+bool ReplayPlayerStep(ReplayPlayer *player){
+    Match *m = player->match;
+    const Replay *r = player->replay;
+    if(SimIsOver(m)) return false;
+
+    SimInput input;
+    input.count = 0;
+    uint32_t next = m->tick + 1;
+    while(player->nextHit < r->hitCount && r->hits[player->nextHit].tick <= next){
+        SimInputAdd(&input, r->hits[player->nextHit].hole, r->hits[player->nextHit].team);
+        player->nextHit++;
+    }
+    SimStep(m, &input);
+    return true;
+}
+
+bool ReplayPlayerInit(ReplayPlayer *player, const Replay *replay, Match *match){
+    memset(player, 0, sizeof(*player));
+    player->replay = replay;
+    player->match = match;
+
+    SimEventFn onEvent = match->onEvent;
+    match->onEvent = NULL;
+    Restart(player);
+
+    bool ok = true;
+    size_t used = 0, capacity = 0;
+    int keyframeCapacity = 0;
+    do{
+        if(match->tick % REPLAY_KEYFRAME_TICKS) continue;
+        size_t size = SimSnapshotSize(match);
+        if(used + size > capacity){
+            capacity = (capacity ? capacity*2 : 16384) + size;
+            uint8_t *grown = realloc(player->keyframeData, capacity);
+            if(!grown){ ok = false; break; }
+            player->keyframeData = grown;
+        }
+        if(player->keyframeCount == keyframeCapacity){
+            keyframeCapacity = keyframeCapacity ? keyframeCapacity*2 : 64;
+            ReplayKeyframe *grown = realloc(player->keyframes, (size_t)keyframeCapacity*sizeof(ReplayKeyframe));
+            if(!grown){ ok = false; break; }
+            player->keyframes = grown;
+        }
+        SimSave(match, player->keyframeData + used, size);
+        player->keyframes[player->keyframeCount++] = (ReplayKeyframe){ match->tick, player->nextHit, used, size };
+        used += size;
+    }while(ReplayPlayerStep(player));
+    player->endTick = match->tick;
+
+    if(ok && replay->finished){
+        player->verified = match->tick == replay->finalTick && HashMatch(match) == replay->finalHash;
+        for(int t=0;t<replay->teamCount;t++) player->verified &= match->scores[t] == replay->finalScores[t];
+    }
+    match->onEvent = onEvent;
+    if(!ok){
+        fprintf(stderr, "REPLAY: out of memory for keyframes\n");
+        ReplayPlayerFree(player);
+        return false;
+    }
+    ReplayPlayerSeek(player, 0);
+    return true;
+}
+
+void ReplayPlayerSeek(ReplayPlayer *player, uint32_t tick){
+    Match *m = player->match;
+    if(tick > player->endTick) tick = player->endTick;
+    int k = (int)(tick/REPLAY_KEYFRAME_TICKS);
+    if(k >= player->keyframeCount) k = player->keyframeCount - 1;
+
+    SimEventFn onEvent = m->onEvent;
+    m->onEvent = NULL;
+    if(k >= 0 && SimLoad(m, player->keyframeData + player->keyframes[k].offset, player->keyframes[k].size)) player->nextHit = player->keyframes[k].nextHit;
+    else Restart(player);
+    while(m->tick < tick && ReplayPlayerStep(player)){}
+    m->onEvent = onEvent;
+}
+
+void ReplayPlayerFree(ReplayPlayer *player){
+    free(player->keyframes);
+    free(player->keyframeData);
+    player->keyframes = NULL;
+    player->keyframeData = NULL;
+    player->keyframeCount = 0;
+}
+
+// ------------------- Resume Files -------------------
+bool MatchSaveFile(const Match *match, const char *path){
+    size_t size = SimSnapshotSize(match);
+    uint8_t *data = malloc(4 + size);
+    if(!data) return false;
+    memcpy(data, "WAMS", 4);
+    SimSave(match, data + 4, size);
+    bool ok = WriteFileAtomic(path, data, 4 + size);
+    free(data);
+    return ok;
+}
+
+bool MatchLoadFile(Match *match, const char *path){
+    size_t size = 0;
+    uint8_t *data = ReadWholeFile(path, &size);
+    if(!data) return false;
+    bool ok = size > 4 && !memcmp(data, "WAMS", 4) && SimLoad(match, data + 4, size - 4);
+    if(!ok) fprintf(stderr, "REPLAY: %s doesn't fit this build or board\n", path);
+    free(data);
+    return ok;
+}
@@ -0,0 +1,78 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+// Match files. A replay is the seed, the board and every hit with the tick it
+// landed on (tick deltas, varint-coded), plus the final result to check
+// against; the sim is deterministic, so that's the whole match. A player
+// rebuilds it at any speed and keeps keyframe snapshots for scrubbing.
+// Resume files are a single snapshot (SimSave) of a match in progress.
+// No raylib dependency.
+
+#include "sim.h"
+
+#define REPLAY_VERSION 1
+#define REPLAY_KEYFRAME_TICKS (2*SIM_TICK_HZ)
+
+typedef struct {
+    uint32_t tick;      // the step whose input carried the hit
+    uint16_t hole;
+    uint8_t team;
+} ReplayHit;
+
+typedef struct {
+    uint64_t seed;
+    int teamCount;
+    SimVec2 hammerSize;
+    SimBoard board;
+
+    ReplayHit *hits;
+    int hitCount, hitCapacity;
+
+    // Set by ReplayEnd()
+    bool finished;
+    uint32_t finalTick;
+    int finalScores[SIM_MAX_TEAMS];
+    uint64_t finalHash;     // SimHash of the final snapshot
+} Replay;
+
+// ------------------- Recording -------------------
+void ReplayBegin(Replay *replay, const Match *match, uint64_t seed);     // right after SimInit
+void ReplayRecordHit(Replay *replay, const Match *match, int hole, int team);   // hits struck before the next SimStep
+void ReplayEnd(Replay *replay, const Match *match);
+void ReplayFree(Replay *replay);
+
+bool ReplaySave(const Replay *replay, const char *path);
+bool ReplayLoad(Replay *replay, const char *path);
+
+// ------------------- Playback -------------------
+typedef struct {
+    uint32_t tick;
+    int nextHit;
+    size_t offset;      // into keyframeData
+    size_t size;
+} ReplayKeyframe;
+
+typedef struct {
+    const Replay *replay;
+    Match *match;           // owned by the caller; its onEvent is kept
+    int nextHit;
+    uint32_t endTick;
+    bool verified;          // the run reproduced the recorded result
+
+    ReplayKeyframe *keyframes;
+    int keyframeCount;
+    uint8_t *keyframeData;
+} ReplayPlayer;
+
+// Runs the whole replay once at full speed (no events), keeping keyframes and
+// checking the result, then rewinds to tick 0
+bool ReplayPlayerInit(ReplayPlayer *player, const Replay *replay, Match *match);
+bool ReplayPlayerStep(ReplayPlayer *player);                // one tick; false at the end
+void ReplayPlayerSeek(ReplayPlayer *player, uint32_t tick); // nearest keyframe, then silent ticks
+void ReplayPlayerFree(ReplayPlayer *player);
+
+// ------------------- Resume Files -------------------
+bool MatchSaveFile(const Match *match, const char *path);  // written to path.tmp, then renamed
+bool MatchLoadFile(Match *match, const char *path);        // match->board etc. must already be set
+
+#endif
@@ -0,0 +1,505 @@
+#include "sim.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ------------------- Board Layout -------------------
+// The old per-frame roll spawned with p = 5/1001 each 60 Hz frame while a hole was idle,
+// i.e. a mean idle gap of 200.2 frames. Scheduling draws that gap directly.
+const SimBoard simDefaultBoard = {
+    5, (1001.0f/5.0f)/60.0f,
+    {
+        {707, 510},
+        {1133, 510},
+        {376, 640},
+        {940, 700},
+        {1490, 640}
+    }
+};
+
+const float roundTime = 101.0f;
+
+const SimRules simDefaultRules = {
+    .spawnWeight = { [MOLE_NORMAL] = 60, [MOLE_GOLDEN] = 5, [MOLE_BOMBER] = 20, [MOLE_EMPTY] = 15 },
+    .moleLifetime = 1.0f,
+    .points = { [MOLE_NORMAL] = 5, [MOLE_GOLDEN] = 10, [MOLE_BOMBER] = -5, [MOLE_EMPTY] = -1 },
+    .missPoints = -1,
+};
+
+static const float hammerSpeed = 15.0f;
+
+// Hammer rest positions: even teams on the left of the board, odd teams on the right
+static SimVec2 HammerHome(int team){
+    return (SimVec2){ (team % 2) ? 1570.0f : 170.0f, 440.0f + (team/2)*150.0f };
+}
+
+// ------------------- RNG -------------------
+void SimRngSeed(SimRng *rng, uint64_t seed, uint64_t stream){
+    rng->state = 0;
+    rng->inc = (stream << 1u) | 1u;
+    SimRngNext(rng);
+    rng->state += seed;
+    SimRngNext(rng);
+}
+
+uint32_t SimRngNext(SimRng *rng){
+    uint64_t old = rng->state;
+    rng->state = old*6364136223846793005ULL + rng->inc;
+    uint32_t xorshifted = (uint32_t)(((old >> 18u) ^ old) >> 27u);
+    uint32_t rot = (uint32_t)(old >> 59u);
+    return (xorshifted >> rot) | (xorshifted << ((-rot) & 31));
+}
+
+int SimRngRange(SimRng *rng, int min, int max){
+    uint32_t range = (uint32_t)(max - min) + 1u;
+    uint32_t threshold = (0u - range) % range;   // reject the biased low end
+    for(;;){
+        uint32_t r = SimRngNext(rng);
+        if(r >= threshold) return min + (int)(r % range);
+    }
+}
+
+float SimRngFloat(SimRng *rng){
+    return (SimRngNext(rng) >> 8)*(1.0f/16777216.0f);
+}
+
+// ------------------- Helpers -------------------
+static void Emit(Match *match, SimEventType type, int hole, int team, int moleType, int value, uint32_t age){
+    if(!match->onEvent) return;
+    SimEvent ev = { type, hole, team, moleType, match->tick, value, age };
+    match->onEvent(match->eventUser, &ev);
+}
+
+static void ResetHammer(SimHammer *h, SimVec2 home){
+    h->pos = h->prevPos = h->startPos = h->targetPos = home;
+    h->isHitting = false;
+    h->animTime = 0;
+    h->idleTime = 0;
+}
+
+static void UpdateHammer(SimHammer *h){
+    h->prevPos = h->pos;
+    h->idleTime += SIM_DT;
+    if(h->idleTime > 1.0f) h->targetPos = h->startPos;
+
+    // Exact exponential ease: same curve at any tick rate and never overshoots
+    float k = 1.0f - expf(-hammerSpeed*SIM_DT);
+    h->pos.x += (h->targetPos.x - h->pos.x) * k;
+    h->pos.y += (h->targetPos.y - h->pos.y) * k;
+
+    if(h->isHitting){
+        h->animTime += SIM_DT;
+        if(h->animTime > 0.2f){ h->isHitting = false; h->animTime = 0; }
+    }
+}
+
+// ------------------- Spawn Scheduler -------------------
+static void SchedulePush(Match *match, uint32_t tick, int hole){
+    int i = match->spawnCount++;
+    while(i > 0){
+        int parent = (i - 1)/2;
+        if(match->spawnQueue[parent].tick <= tick) break;
+        match->spawnQueue[i] = match->spawnQueue[parent];
+        i = parent;
+    }
+    match->spawnQueue[i] = (SimSpawn){ tick, hole };
+}
+
+static SimSpawn SchedulePop(Match *match){
+    SimSpawn top = match->spawnQueue[0];
+    SimSpawn last = match->spawnQueue[--match->spawnCount];
+    int n = match->spawnCount, i = 0;
+    for(;;){
+        int child = 2*i + 1;
+        if(child >= n) break;
+        if(child + 1 < n && match->spawnQueue[child + 1].tick < match->spawnQueue[child].tick) child++;
+        if(last.tick <= match->spawnQueue[child].tick) break;
+        match->spawnQueue[i] = match->spawnQueue[child];
+        i = child;
+    }
+    if(n > 0) match->spawnQueue[i] = last;
+    return top;
+}
+
+// Exponentially distributed idle gap, rounded up to whole ticks
+static void ScheduleSpawn(Match *match, int hole){
+    float u = SimRngFloat(&match->rng);
+    uint32_t ticks = (uint32_t)ceilf(-logf(1.0f - u)*match->board->spawnMeanIdle*SIM_TICK_HZ);
+    if(ticks < 1) ticks = 1;
+    SchedulePush(match, match->tick + ticks, hole);
+}
+
+// ------------------- Storage -------------------
+// Every per-hole array in one block, widest elements first so each stays aligned.
+// A tournament of small boards then costs a few hundred bytes a match, not SIM_MAX_HOLES worth.
+static bool Reserve(Match *match, int holes){
+    if(holes < 1) holes = 1;
+    if(!match->storage || holes > match->storageHoles){
+        size_t words = ((size_t)holes + 63)/64;
+        void *block = malloc(words*2*sizeof(uint64_t) + (size_t)holes*(sizeof(float) + sizeof(SimSpawn) + 2*sizeof(uint16_t) + 1));
+        if(!block) return false;
+        free(match->storage);
+        match->storage = block;
+        match->storageHoles = holes;
+    }
+    size_t words = ((size_t)match->storageHoles + 63)/64, n = (size_t)match->storageHoles;
+    SimMoles *m = &match->moles;
+    m->visible = match->storage;
+    m->hit = m->visible + words;
+    m->timer = (float *)(m->hit + words);
+    match->spawnQueue = (SimSpawn *)(m->timer + n);
+    m->activeHole = (uint16_t *)(match->spawnQueue + n);
+    m->slot = m->activeHole + n;
+    m->type = (uint8_t *)(m->slot + n);
+    return true;
+}
+
+void SimFree(Match *match){
+    free(match->storage);
+    match->storage = NULL;
+    match->storageHoles = 0;
+    match->moles = (SimMoles){0};
+    match->spawnQueue = NULL;
+    match->spawnCount = 0;
+}
+
+// ------------------- Initialize Match -------------------
+static const SimBoard noBoard = { .spawnMeanIdle = 1.0f };     // what a match without storage plays on
+
+bool SimInit(Match *match, uint64_t seed){
+    // Wiring set up by the owner survives a restart, and so does the storage
+    SimEventFn onEvent = match->onEvent;
+    void *eventUser = match->eventUser;
+    SimVec2 hammerSize = match->hammerSize;
+    const SimBoard *board = match->board;
+    const SimRules *rules = match->rules;
+    int teamCount = match->teamCount;
+    void *storage = match->storage;
+    int storageHoles = match->storageHoles;
+
+    memset(match, 0, sizeof(*match));
+    match->onEvent = onEvent;
+    match->eventUser = eventUser;
+    match->board = board ? board : &simDefaultBoard;
+    match->rules = rules ? rules : &simDefaultRules;
+    match->teamCount = (teamCount >= 1 && teamCount <= SIM_MAX_TEAMS) ? teamCount : 2;
+    match->hammerSize = (hammerSize.x > 0) ? hammerSize : (SimVec2){180, 180};
+    match->storage = storage;
+    match->storageHoles = storageHoles;
+    bool ok = Reserve(match, match->board->holeCount);
+    if(ok){
+        memset(match->moles.visible, 0, (match->board->holeCount + 63)/64*sizeof(uint64_t));
+        memset(match->moles.hit, 0, (match->board->holeCount + 63)/64*sizeof(uint64_t));
+    }else match->board = &noBoard;
+
+    SimRngSeed(&match->rng, seed, 0);
+    match->timer = roundTime;
+    for(int t=0;t<match->teamCount;t++) ResetHammer(&match->hammers[t], HammerHome(t));
+    for(int i=0;i<match->board->holeCount;i++) ScheduleSpawn(match, i);
+    return ok;
+}
+
+// ------------------- Mole & Hit Functions -------------------
+// Spawn a mole in hole i. Types are rolled in this order, so the default
+// weights give the same draws as the old r<60/80/85 thresholds.
+static const MoleType spawnOrder[4] = { MOLE_NORMAL, MOLE_BOMBER, MOLE_GOLDEN, MOLE_EMPTY };
+
+static void SpawnMole(Match *match, int i){
+    SimMoles *m = &match->moles;
+    const SimRules *rules = match->rules;
+    int total = 0;
+    for(int k=0;k<4;k++) total += rules->spawnWeight[k];
+    int r = SimRngRange(&match->rng, 0, (total > 0 ? total : 1) - 1);
+    m->type[i] = MOLE_EMPTY;
+    for(int k=0;k<4;k++){
+        r -= rules->spawnWeight[spawnOrder[k]];
+        if(r < 0){ m->type[i] = (uint8_t)spawnOrder[k]; break; }
+    }
+
+    int s = m->activeCount++;
+    m->timer[s] = rules->moleLifetime;
+    m->activeHole[s] = (uint16_t)i;
+    m->slot[i] = (uint16_t)s;
+    m->visible[i >> 6] |= 1ull << (i & 63);
+    m->hit[i >> 6] &= ~(1ull << (i & 63));
+    Emit(match, SIM_EVENT_MOLE_POP, i, -1, m->type[i], 0, 0);
+}
+
+// The last active mole takes over the freed slot
+static void HideMole(SimMoles *m, int i){
+    int s = m->slot[i], last = --m->activeCount;
+    m->timer[s] = m->timer[last];
+    m->activeHole[s] = m->activeHole[last];
+    m->slot[m->activeHole[s]] = (uint16_t)s;
+    m->visible[i >> 6] &= ~(1ull << (i & 63));
+}
+
+// Contiguous floats, no branches: compiles to packed SIMD subtracts
+static void TickTimers(float *restrict timer, int count, float dt){
+    for(int s=0;s<count;s++) timer[s] -= dt;
+}
+
+// Count down visible moles, then pop whatever the scheduler has due this tick
+static void UpdateMoles(Match *match){
+    SimMoles *m = &match->moles;
+    TickTimers(m->timer, m->activeCount, SIM_DT);
+
+    uint16_t expired[SIM_MAX_HOLES];
+    int expiredCount = 0;
+    for(int s=0;s<m->activeCount;s++){
+        if(m->timer[s] <= 0) expired[expiredCount++] = m->activeHole[s];
+    }
+    // Reschedule in hole order: each reschedule draws from the match RNG
+    for(int k=1;k<expiredCount;k++){
+        uint16_t v = expired[k];
+        int j = k;
+        while(j > 0 && expired[j-1] > v){ expired[j] = expired[j-1]; j--; }
+        expired[j] = v;
+    }
+    for(int k=0;k<expiredCount;k++){
+        HideMole(m, expired[k]);
+        ScheduleSpawn(match, expired[k]);
+        Emit(match, SIM_EVENT_MOLE_EXPIRE, expired[k], -1, m->type[expired[k]], SimMoleHit(m, expired[k]), 0);
+    }
+
+    while(match->spawnCount > 0 && match->spawnQueue[0].tick <= match->tick){
+        SpawnMole(match, SchedulePop(match).hole);
+    }
+}
+
+// Handle hammer hit for a hole
+void SimHit(Match *match, int holeIndex, int team){
+    if(holeIndex < 0 || holeIndex >= match->board->holeCount || team < 0 || team >= match->teamCount) return;
+    int *score = &match->scores[team];
+    SimMoles *m = &match->moles;
+
+    if(!SimMoleVisible(m, holeIndex)){
+        *score += match->rules->missPoints;
+        if(*score < 0) *score = 0;
+        Emit(match, SIM_EVENT_HIT, holeIndex, team, -1, *score, 0);
+    }else{
+        if(SimMoleHit(m, holeIndex)) return;
+        m->hit[holeIndex >> 6] |= 1ull << (holeIndex & 63);
+
+        *score += match->rules->points[m->type[holeIndex]];
+        if(*score < 0) *score = 0;
+        // Ticks since it popped: its timer started at the lifetime and has run down once a tick since
+        float up = match->rules->moleLifetime - m->timer[m->slot[holeIndex]];
+        Emit(match, SIM_EVENT_HIT, holeIndex, team, m->type[holeIndex], *score, (uint32_t)(up*SIM_TICK_HZ + 0.5f) + 1);
+    }
+
+    // Move hammer animation
+    SimHammer *h = &match->hammers[team];
+    SimVec2 pos = match->board->pos[holeIndex];
+    h->targetPos = (SimVec2){pos.x - match->hammerSize.x/2, pos.y - match->hammerSize.y/2};
+    h->isHitting = true;
+    h->idleTime = 0;
+}
+
+// ------------------- Step -------------------
+void SimStep(Match *match, const SimInput *input){
+    bool wasOver = SimIsOver(match);
+    match->tick++;
+    match->timer = roundTime - match->tick*SIM_DT;   // derived from the tick count, so no drift
+    if(!wasOver && SimIsOver(match)) Emit(match, SIM_EVENT_ROUND_OVER, -1, -1, -1, 0, 0);
+
+    // Hits first: a press made during this tick sees the board as it was when it was made
+    if(input){
+        for(int i=0;i<input->count;i++) SimHit(match, input->hits[i].hole, input->hits[i].team);
+    }
+
+    UpdateMoles(match);
+
+    for(int t=0;t<match->teamCount;t++) UpdateHammer(&match->hammers[t]);
+}
+
+bool SimIsOver(const Match *match){
+    return match->timer <= 0;
+}
+
+int SimWinner(const Match *match){
+    int best = 0, tied = 0;
+    for(int t=1;t<match->teamCount;t++){
+        if(match->scores[t] > match->scores[best]){ best = t; tied = 0; }
+        else if(match->scores[t] == match->scores[best]) tied = 1;
+    }
+    return tied ? -1 : best;
+}
+
+SimVec2 SimHammerLerp(const SimHammer *hammer, float alpha){
+    return (SimVec2){ hammer->prevPos.x + (hammer->pos.x - hammer->prevPos.x)*alpha,
+                      hammer->prevPos.y + (hammer->pos.y - hammer->prevPos.y)*alpha };
+}
+
+void SimInputAdd(SimInput *input, int hole, int team){
+    if(input->count < SIM_MAX_HITS) input->hits[input->count++] = (SimHitCmd){ (uint16_t)hole, (uint8_t)team };
+}
+
+void SimRunMatch(Match *match, const SimInputSource *source){
+    SimInput input;
+    while(!SimIsOver(match)){
+        input.count = 0;
+        if(source && source->poll) source->poll(source->user, match, &input);
+        SimStep(match, &input);
+    }
+}
+
+// ------------------- Snapshots -------------------
+typedef struct { uint8_t *p, *end; } Writer;
+typedef struct { const uint8_t *p, *end; bool ok; } Reader;
+
+static void Put(Writer *w, uint64_t v, int bytes){
+    for(int i=0;i<bytes;i++){ if(w->p < w->end) *w->p = (uint8_t)(v >> (8*i)); w->p++; }
+}
+
+static void PutF32(Writer *w, float f){
+    uint32_t v;
+    memcpy(&v, &f, 4);
+    Put(w, v, 4);
+}
+
+static uint64_t Get(Reader *r, int bytes){
+    if(r->end - r->p < bytes){ r->ok = false; r->p = r->end; return 0; }
+    uint64_t v = 0;
+    for(int i=0;i<bytes;i++) v |= (uint64_t)*r->p++ << (8*i);
+    return v;
+}
+
+static float GetF32(Reader *r){
+    uint32_t v = (uint32_t)Get(r, 4);
+    float f;
+    memcpy(&f, &v, 4);
+    return f;
+}
+
+static const int hammerBytes = 8*4 + 1 + 2*4;
+
+size_t SimSnapshotSize(const Match *match){
+    return 1 + 16 + 4 + 4 + 2 + 1
+         + (size_t)match->teamCount*(4 + hammerBytes)
+         + 2 + (size_t)match->moles.activeCount*8
+         + 2 + (size_t)match->spawnCount*6;
+}
+
+size_t SimSave(const Match *match, uint8_t *out, size_t capacity){
+    size_t size = SimSnapshotSize(match);
+    if(size > capacity) return 0;
+    Writer w = { out, out + capacity };
+
+    Put(&w, SIM_SNAPSHOT_VERSION, 1);
+    Put(&w, match->rng.state, 8);
+    Put(&w, match->rng.inc, 8);
+    Put(&w, match->tick, 4);
+    PutF32(&w, match->timer);
+    Put(&w, (uint32_t)match->board->holeCount, 2);
+    Put(&w, (uint32_t)match->teamCount, 1);
+
+    for(int t=0;t<match->teamCount;t++){
+        const SimHammer *h = &match->hammers[t];
+        Put(&w, (uint32_t)match->scores[t], 4);
+        const SimVec2 *v[4] = { &h->pos, &h->prevPos, &h->targetPos, &h->startPos };
+        for(int k=0;k<4;k++){ PutF32(&w, v[k]->x); PutF32(&w, v[k]->y); }
+        Put(&w, h->isHitting, 1);
+        PutF32(&w, h->animTime);
+        PutF32(&w, h->idleTime);
+    }
+
+    // Visible moles in slot order, so a load rebuilds the same packing
+    const SimMoles *m = &match->moles;
+    Put(&w, (uint32_t)m->activeCount, 2);
+    for(int s=0;s<m->activeCount;s++){
+        int hole = m->activeHole[s];
+        Put(&w, (uint32_t)hole, 2);
+        Put(&w, m->type[hole], 1);
+        Put(&w, SimMoleHit(m, hole), 1);
+        PutF32(&w, m->timer[s]);
+    }
+
+    // The heap array as-is: ties pop in the same order after a load
+    Put(&w, (uint32_t)match->spawnCount, 2);
+    for(int i=0;i<match->spawnCount;i++){
+        Put(&w, match->spawnQueue[i].tick, 4);
+        Put(&w, (uint32_t)match->spawnQueue[i].hole, 2);
+    }
+    return size;
+}
+
+// Visible moles and the spawn queue. Run once to check them, then again to
+// apply, so a bad snapshot leaves the match's arrays as they were.
+static bool LoadMoles(Reader *r, Match *m, int holeCount, bool apply){
+    uint64_t seen[SIM_MAX_HOLES/64] = {0};
+    SimMoles *moles = &m->moles;
+    int activeCount = (int)Get(r, 2);
+    if(activeCount > holeCount) return false;
+    if(apply) memset(moles->hit, 0, (holeCount + 63)/64*sizeof(uint64_t));
+    for(int s=0;s<activeCount;s++){
+        int hole = (int)Get(r, 2);
+        if(hole >= holeCount || ((seen[hole >> 6] >> (hole & 63)) & 1u)) return false;
+        seen[hole >> 6] |= 1ull << (hole & 63);
+        uint8_t type = (uint8_t)Get(r, 1);
+        bool hit = Get(r, 1) != 0;
+        float timer = GetF32(r);
+        if(!apply) continue;
+        moles->activeHole[s] = (uint16_t)hole;
+        moles->slot[hole] = (uint16_t)s;
+        moles->type[hole] = type;
+        if(hit) moles->hit[hole >> 6] |= 1ull << (hole & 63);
+        moles->timer[s] = timer;
+    }
+
+    int spawnCount = (int)Get(r, 2);
+    if(spawnCount > holeCount) return false;
+    for(int i=0;i<spawnCount;i++){
+        SimSpawn spawn = { (uint32_t)Get(r, 4), (int)Get(r, 2) };
+        if(spawn.hole >= holeCount) return false;
+        if(apply) m->spawnQueue[i] = spawn;
+    }
+    if(!r->ok || r->p != r->end) return false;
+
+    if(apply){
+        memcpy(moles->visible, seen, (holeCount + 63)/64*sizeof(uint64_t));
+        moles->activeCount = activeCount;
+        m->spawnCount = spawnCount;
+    }
+    return true;
+}
+
+bool SimLoad(Match *match, const uint8_t *data, size_t size){
+    Reader r = { data, data + size, true };
+    if(Get(&r, 1) != SIM_SNAPSHOT_VERSION) return false;
+
+    const int holeCount = match->board ? match->board->holeCount : simDefaultBoard.holeCount;
+    if(!Reserve(match, holeCount)) return false;
+    Match m = *match;
+    m.rng.state = Get(&r, 8);
+    m.rng.inc = Get(&r, 8);
+    m.tick = (uint32_t)Get(&r, 4);
+    m.timer = GetF32(&r);
+    if((int)Get(&r, 2) != holeCount) return false;
+    m.teamCount = (int)Get(&r, 1);
+    if(m.teamCount < 1 || m.teamCount > SIM_MAX_TEAMS) return false;
+
+    for(int t=0;t<m.teamCount;t++){
+        SimHammer *h = &m.hammers[t];
+        m.scores[t] = (int)(uint32_t)Get(&r, 4);
+        SimVec2 *v[4] = { &h->pos, &h->prevPos, &h->targetPos, &h->startPos };
+        for(int k=0;k<4;k++){ v[k]->x = GetF32(&r); v[k]->y = GetF32(&r); }
+        h->isHitting = Get(&r, 1) != 0;
+        h->animTime = GetF32(&r);
+        h->idleTime = GetF32(&r);
+    }
+
+    Reader moles = r;
+    if(!LoadMoles(&r, &m, holeCount, false)) return false;
+    LoadMoles(&moles, &m, holeCount, true);
+    if(!m.board) m.board = &simDefaultBoard;
+    if(!m.rules) m.rules = &simDefaultRules;
+    *match = m;
+    return true;
+}
+
+uint64_t SimHash(const uint8_t *data, size_t size){
+    uint64_t h = 1469598103934665603ULL;
+    for(size_t i=0;i<size;i++){ h ^= data[i]; h *= 1099511628211ULL; }
+    return h;
+}
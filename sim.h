@@ -0,0 +1,170 @@
+#ifndef SIM_H
+#define SIM_H
+
+// Match simulation core: mole spawning, hits, scoring, timer and hammer motion.
+// Has no raylib dependency so it can run headless, as fast as the CPU allows.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Boards are loaded at runtime; this bounds their hole count
+#define SIM_MAX_HOLES 1024
+
+// Team 0 is red and team 1 blue; more teams come from the key bindings
+#define SIM_MAX_TEAMS 8
+
+// Fixed simulation rate, independent of the display frame rate
+#define SIM_TICK_HZ 120
+#define SIM_DT (1.0f/SIM_TICK_HZ)
+
+// ------------------- Mole Types -------------------
+typedef enum { MOLE_NORMAL = 0, MOLE_GOLDEN = 1, MOLE_BOMBER = 2, MOLE_EMPTY = 3 } MoleType;
+
+typedef struct { float x, y; } SimVec2;
+
+// ------------------- RNG -------------------
+// PCG32: every match owns its stream, so a seed fully determines the match
+typedef struct { uint64_t state; uint64_t inc; } SimRng;
+
+void SimRngSeed(SimRng *rng, uint64_t seed, uint64_t stream);
+uint32_t SimRngNext(SimRng *rng);
+int SimRngRange(SimRng *rng, int min, int max);   // inclusive, same contract as GetRandomValue
+float SimRngFloat(SimRng *rng);                    // [0,1)
+
+// ------------------- Board -------------------
+typedef struct {
+    int holeCount;
+    float spawnMeanIdle;        // mean seconds a hole stays empty between moles
+    SimVec2 pos[SIM_MAX_HOLES];
+} SimBoard;
+
+// ------------------- Rules -------------------
+// Gameplay numbers the designers tune (tools/tuner.c sweeps them). Spawn weights
+// are relative; negative points are penalties, and scores never drop below 0.
+typedef struct {
+    int spawnWeight[4];     // by MoleType
+    float moleLifetime;     // seconds a mole stays up
+    int points[4];          // by MoleType
+    int missPoints;         // striking an empty hole
+} SimRules;
+
+// ------------------- Match State -------------------
+// Moles as a structure of arrays. Visible moles are packed at the front of
+// timer/activeHole, so a tick touches only the moles on screen; per-hole flags
+// are bitsets. The arrays are sized to the board, in the match's storage block.
+typedef struct {
+    float *timer;               // lifetime left, by active slot
+    uint16_t *activeHole;       // hole in each active slot
+    uint16_t *slot;             // active slot of each hole, while visible
+    int activeCount;
+    uint8_t *type;              // MoleType, by hole
+    uint64_t *visible;          // by hole
+    uint64_t *hit;              // by hole
+} SimMoles;
+
+static inline bool SimMoleVisible(const SimMoles *moles, int hole){ return (moles->visible[hole >> 6] >> (hole & 63)) & 1u; }
+static inline bool SimMoleHit(const SimMoles *moles, int hole){ return (moles->hit[hole >> 6] >> (hole & 63)) & 1u; }
+
+typedef struct {
+    SimVec2 pos;
+    SimVec2 prevPos;        // position at the start of the last tick, for display interpolation
+    SimVec2 targetPos;
+    SimVec2 startPos;
+    bool isHitting;
+    float animTime;
+    float idleTime;
+} SimHammer;
+
+// Things the presentation layer reacts to (sounds, effects)
+typedef enum { SIM_EVENT_MOLE_POP, SIM_EVENT_HIT, SIM_EVENT_ROUND_OVER, SIM_EVENT_MOLE_EXPIRE } SimEventType;
+
+typedef struct {
+    SimEventType type;
+    int hole;
+    int team;
+    int moleType;   // for SIM_EVENT_HIT: MoleType, or -1 when the hole was empty
+    uint32_t tick;  // match tick it happened on
+    int value;      // SIM_EVENT_HIT: the team's score after it; SIM_EVENT_MOLE_EXPIRE: 1 if it was hit
+    uint32_t age;   // SIM_EVENT_HIT on a mole: ticks since it popped
+} SimEvent;
+
+typedef void (*SimEventFn)(void *user, const SimEvent *event);
+
+// Next spawn time of an idle hole, kept in a min-heap so idle holes cost nothing per tick
+typedef struct {
+    uint32_t tick;
+    int hole;
+} SimSpawn;
+
+typedef struct {
+    SimRng rng;
+    uint32_t tick;
+    const SimBoard *board;  // set before SimInit, or the built-in board is used
+    const SimRules *rules;  // set before SimInit, or simDefaultRules
+    SimMoles moles;
+    SimSpawn *spawnQueue;   // one slot per hole
+    int spawnCount;
+    int teamCount;          // set before SimInit, or 2
+    SimHammer hammers[SIM_MAX_TEAMS];
+    int scores[SIM_MAX_TEAMS];
+    float timer;
+    SimVec2 hammerSize;     // hammer sprite size, used to center the hammer on a hole
+    SimEventFn onEvent;     // optional
+    void *eventUser;
+    void *storage;          // the per-hole arrays above, for storageHoles holes; SimFree releases it
+    int storageHoles;
+} Match;
+
+// ------------------- Input -------------------
+// Hits struck during one step, applied in order
+#define SIM_MAX_HITS 64
+
+typedef struct {
+    uint16_t hole;
+    uint8_t team;
+} SimHitCmd;
+
+typedef struct {
+    int count;
+    SimHitCmd hits[SIM_MAX_HITS];
+} SimInput;
+
+void SimInputAdd(SimInput *input, int hole, int team);   // extra hits past SIM_MAX_HITS are dropped
+
+// Injectable input: the game polls raylib, the headless driver plugs in bots
+typedef struct {
+    void (*poll)(void *user, const Match *match, SimInput *input);
+    void *user;
+} SimInputSource;
+
+// ------------------- Defaults -------------------
+extern const SimBoard simDefaultBoard;     // the original 5-hole board
+extern const SimRules simDefaultRules;     // 60/20/5/15 spawn mix, +5/+10/-5/-1, 1 s moles
+extern const float roundTime;
+
+// ------------------- API -------------------
+// Keeps the storage block when the board fits it. False if it can't be allocated:
+// the match then runs on an empty board.
+bool SimInit(Match *match, uint64_t seed);
+void SimFree(Match *match);
+void SimStep(Match *match, const SimInput *input);       // advances one SIM_DT tick
+void SimHit(Match *match, int holeIndex, int team);
+int SimWinner(const Match *match);      // team with the top score, or -1 for a draw
+bool SimIsOver(const Match *match);
+SimVec2 SimHammerLerp(const SimHammer *hammer, float alpha);   // alpha = leftover tick fraction
+
+// Runs a whole match tick by tick, polling input before every tick
+void SimRunMatch(Match *match, const SimInputSource *source);
+
+// ------------------- Snapshots -------------------
+// Canonical little-endian image of the match state (no board, rules, callbacks
+// or hammer size): equal states give equal bytes, so images can be hashed and diffed.
+#define SIM_SNAPSHOT_VERSION 1
+
+size_t SimSnapshotSize(const Match *match);
+size_t SimSave(const Match *match, uint8_t *out, size_t capacity);   // bytes written, 0 if it doesn't fit
+bool SimLoad(Match *match, const uint8_t *data, size_t size);        // match->board etc. must already be set
+uint64_t SimHash(const uint8_t *data, size_t size);                  // FNV-1a
+
+#endif
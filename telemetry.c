@@ -0,0 +1,215 @@
+#if !defined(_WIN32)
+    #define _POSIX_C_SOURCE 200112L     // nanosleep under -std=c11
+#endif
+#include "telemetry.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(PLATFORM_WEB)
+    #define TELEMETRY_THREADS 0
+#else
+    #define TELEMETRY_THREADS 1
+    #include <pthread.h>
+#endif
+
+#if defined(_WIN32)
+    void __stdcall Sleep(unsigned long ms);
+#endif
+
+#if TELEMETRY_THREADS
+#define BATCH_LINES 256
+#define LINE_BYTES 192
+
+// Producer and consumer positions on their own cache lines, so pushes don't
+// bounce the line the writer is polling
+static struct {
+    TelemetryEvent ring[TELEMETRY_RING];
+    _Alignas(64) atomic_uint_fast64_t head;     // next slot to fill; written by the game thread
+    uint64_t cachedTail;                        // game thread's last look at tail
+    atomic_uint_fast64_t dropped;
+    _Alignas(64) atomic_uint_fast64_t tail;     // next slot to write out; written by the writer
+    atomic_bool running;
+
+    pthread_t thread;
+    bool open;
+    FILE *file;
+    char path[256];
+    long fileBytes;
+    uint64_t droppedReported;
+    atomic_uint_fast64_t written;
+    atomic_uint_fast64_t lost;
+    atomic_int rotations;
+} tel;
+
+static const char *const typeNames[] = { "match_start", "spawn", "hit", "miss", "expire", "match_end", "state" };
+static const char *const moleNames[] = { "normal", "golden", "bomber", "empty" };
+
+static void SleepMs(int ms){
+#if defined(_WIN32)
+    Sleep((unsigned long)ms);
+#else
+    struct timespec ts = { 0, ms*1000000L };
+    nanosleep(&ts, NULL);
+#endif
+}
+
+// ------------------- Game Thread -------------------
+void TelemetryPush(const TelemetryEvent *event){
+    if(!tel.open) return;
+    uint64_t head = atomic_load_explicit(&tel.head, memory_order_relaxed);
+    if(head - tel.cachedTail >= TELEMETRY_RING){
+        tel.cachedTail = atomic_load_explicit(&tel.tail, memory_order_acquire);
+        if(head - tel.cachedTail >= TELEMETRY_RING){
+            atomic_fetch_add_explicit(&tel.dropped, 1, memory_order_relaxed);
+            return;
+        }
+    }
+    tel.ring[head & (TELEMETRY_RING - 1)] = *event;
+    atomic_store_explicit(&tel.head, head + 1, memory_order_release);
+}
+
+// ------------------- Writer Thread -------------------
+// F -> F.1 -> F.2 ..., the oldest falls off
+static void Rotate(void){
+    fclose(tel.file);
+    char from[272], to[272];
+    snprintf(to, sizeof(to), "%s.%d", tel.path, TELEMETRY_KEEP_FILES);
+    remove(to);
+    for(int i=TELEMETRY_KEEP_FILES-1;i>=1;i--){
+        snprintf(from, sizeof(from), "%s.%d", tel.path, i);
+        snprintf(to, sizeof(to), "%s.%d", tel.path, i + 1);
+        rename(from, to);
+    }
+    snprintf(to, sizeof(to), "%s.1", tel.path);
+    rename(tel.path, to);
+    tel.file = fopen(tel.path, "w");
+    tel.fileBytes = 0;
+    atomic_fetch_add(&tel.rotations, 1);
+    if(!tel.file) fprintf(stderr, "TELEMETRY: cannot reopen %s after rotating, events are lost until it can\n", tel.path);
+}
+
+static int FormatEvent(char *out, const TelemetryEvent *e){
+    int n = snprintf(out, LINE_BYTES, "{\"t\":%.3f,\"match\":%u,\"tick\":%u,\"ev\":\"%s\"",
+                     e->time, (unsigned)e->match, (unsigned)e->tick, e->type < 7 ? typeNames[e->type] : "?");
+    if(e->team >= 0) n += snprintf(out + n, LINE_BYTES - n, ",\"team\":%d", e->team);
+    if(e->hole >= 0) n += snprintf(out + n, LINE_BYTES - n, ",\"hole\":%d", e->hole);
+    if(e->moleType >= 0 && e->moleType < 4) n += snprintf(out + n, LINE_BYTES - n, ",\"mole\":\"%s\"", moleNames[e->moleType]);
+    switch(e->type){
+        case TEL_HIT: n += snprintf(out + n, LINE_BYTES - n, ",\"reaction_ms\":%d,\"score\":%d", (int)e->value, (int)e->score); break;
+        case TEL_MISS: case TEL_MATCH_END: n += snprintf(out + n, LINE_BYTES - n, ",\"score\":%d", (int)e->score); break;
+        case TEL_MOLE_EXPIRE: n += snprintf(out + n, LINE_BYTES - n, ",\"was_hit\":%s", e->value ? "true" : "false"); break;
+        case TEL_MATCH_START: n += snprintf(out + n, LINE_BYTES - n, ",\"teams\":%d", (int)e->value); break;
+        case TEL_STATE: n += snprintf(out + n, LINE_BYTES - n, ",\"state\":%d", (int)e->value); break;
+        default: break;
+    }
+    n += snprintf(out + n, LINE_BYTES - n, "}\n");
+    return n < LINE_BYTES ? n : LINE_BYTES - 1;
+}
+
+// Without a file (the rotation's reopen failed) each batch tries again, and counts its lines lost until then
+static void WriteOut(const char *text, int length, int lines){
+    if(!tel.file && (tel.file = fopen(tel.path, "a")) != NULL){
+        fseek(tel.file, 0, SEEK_END);
+        tel.fileBytes = ftell(tel.file);
+        fprintf(stderr, "TELEMETRY: writing %s again\n", tel.path);
+    }
+    if(!tel.file){
+        atomic_fetch_add(&tel.lost, lines);
+        return;
+    }
+    fwrite(text, 1, length, tel.file);
+    atomic_fetch_add(&tel.written, lines);
+    tel.fileBytes += length;
+    if(tel.fileBytes >= TELEMETRY_ROTATE_BYTES) Rotate();
+}
+
+// Copies out up to a batch, formats it, then frees the slots
+static bool Drain(void){
+    static char buffer[(BATCH_LINES + 1)*LINE_BYTES];   // plus a drop report
+    uint64_t tail = atomic_load_explicit(&tel.tail, memory_order_relaxed);
+    uint64_t head = atomic_load_explicit(&tel.head, memory_order_acquire);
+    int count = (head - tail > BATCH_LINES) ? BATCH_LINES : (int)(head - tail);
+
+    int length = 0, lines = count;
+    uint64_t dropped = atomic_load_explicit(&tel.dropped, memory_order_relaxed);
+    if(dropped != tel.droppedReported){
+        length += snprintf(buffer, LINE_BYTES, "{\"ev\":\"dropped\",\"count\":%llu}\n", (unsigned long long)(dropped - tel.droppedReported));
+        tel.droppedReported = dropped;
+        lines++;
+    }
+    for(int i=0;i<count;i++) length += FormatEvent(buffer + length, &tel.ring[(tail + i) & (TELEMETRY_RING - 1)]);
+    atomic_store_explicit(&tel.tail, tail + count, memory_order_release);
+
+    if(length > 0) WriteOut(buffer, length, lines);
+    return count > 0;
+}
+
+static void *WriterThread(void *arg){
+    (void)arg;
+    while(atomic_load(&tel.running)){
+        if(!Drain()){
+            if(tel.file) fflush(tel.file);
+            SleepMs(20);
+        }
+    }
+    while(Drain()){}
+    return NULL;
+}
+
+// ------------------- Open/Close -------------------
+bool TelemetryOpen(const char *path){
+    if(tel.open) return true;
+    snprintf(tel.path, sizeof(tel.path), "%s", path);
+    tel.file = fopen(path, "a");
+    if(!tel.file){
+        fprintf(stderr, "TELEMETRY: cannot open %s\n", path);
+        return false;
+    }
+    fseek(tel.file, 0, SEEK_END);
+    tel.fileBytes = ftell(tel.file);
+    atomic_store(&tel.head, 0);
+    atomic_store(&tel.tail, 0);
+    atomic_store(&tel.dropped, 0);
+    tel.cachedTail = 0;
+    atomic_store(&tel.running, true);
+    if(pthread_create(&tel.thread, NULL, WriterThread, NULL) != 0){
+        fclose(tel.file);
+        tel.file = NULL;
+        fprintf(stderr, "TELEMETRY: cannot start the writer thread\n");
+        return false;
+    }
+    tel.open = true;
+    fprintf(stderr, "TELEMETRY: writing %s\n", path);
+    return true;
+}
+
+void TelemetryClose(void){
+    if(!tel.open) return;
+    tel.open = false;
+    atomic_store(&tel.running, false);
+    pthread_join(tel.thread, NULL);
+    if(tel.file) fclose(tel.file);
+    tel.file = NULL;
+}
+
+bool TelemetryEnabled(void){
+    return tel.open;
+}
+
+TelemetryStats TelemetryGetStats(void){
+    return (TelemetryStats){ atomic_load(&tel.head), atomic_load(&tel.dropped), atomic_load(&tel.written), atomic_load(&tel.lost),
+                             atomic_load(&tel.rotations) };
+}
+#else
+bool TelemetryOpen(const char *path){
+    fprintf(stderr, "TELEMETRY: not available in this build, ignoring %s\n", path);
+    return false;
+}
+
+void TelemetryClose(void){}
+bool TelemetryEnabled(void){ return false; }
+void TelemetryPush(const TelemetryEvent *event){ (void)event; }
+TelemetryStats TelemetryGetStats(void){ return (TelemetryStats){0}; }
+#endif
@@ -0,0 +1,59 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+// Gameplay telemetry. The game thread pushes fixed-size records into a
+// single-producer/single-consumer ring (no locks, no allocation, no I/O); a
+// background thread drains it in batches and appends NDJSON lines to a file,
+// rotating it by size. A full ring drops the record and counts it, and the
+// writer logs every drop as its own line so gaps in the data are explicit.
+//
+//   {"t":12.345,"match":3,"tick":1480,"ev":"hit","team":0,"hole":2,"mole":"golden","reaction_ms":342,"score":25}
+//
+// No raylib here; the caller supplies the clock. Builds without threads
+// (PLATFORM_WEB) can't open a log, and pushes are no-ops.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define TELEMETRY_RING 4096             // records, power of two
+#define TELEMETRY_ROTATE_BYTES (8 << 20)
+#define TELEMETRY_KEEP_FILES 4          // rotated files kept: F.1 ... F.4
+
+typedef enum {
+    TEL_MATCH_START,    // value: team count
+    TEL_MOLE_SPAWN,
+    TEL_HIT,            // value: reaction time since the spawn, ms
+    TEL_MISS,           // struck an empty hole
+    TEL_MOLE_EXPIRE,    // value: 1 if it had been hit
+    TEL_MATCH_END,      // one per team, with the final score
+    TEL_STATE           // value: new game state
+} TelemetryType;
+
+typedef struct {
+    double time;        // seconds, the game's clock
+    uint32_t match;
+    uint32_t tick;      // simulation tick
+    int32_t value;      // see TelemetryType
+    int32_t score;      // the team's score after the event
+    int16_t hole;
+    int8_t team;
+    int8_t moleType;    // MoleType, -1 for none
+    uint8_t type;       // TelemetryType
+    uint8_t pad[3];
+} TelemetryEvent;       // 32 bytes
+
+typedef struct {
+    uint64_t pushed;
+    uint64_t dropped;   // ring full
+    uint64_t written;   // lines, including drop reports
+    uint64_t lost;      // lines with no file to go to: a rotation couldn't reopen it
+    int rotations;
+} TelemetryStats;
+
+bool TelemetryOpen(const char *path);
+void TelemetryClose(void);      // drains what's queued, then joins the writer
+bool TelemetryEnabled(void);
+void TelemetryPush(const TelemetryEvent *event);   // game thread only
+TelemetryStats TelemetryGetStats(void);
+
+#endif
@@ -0,0 +1,59 @@
+#include "textcache.h"
+#include "atlas.h"
+
+int textLayoutBuilds = 0;
+
+// ------------------- Layout -------------------
+// Mirrors DrawTextEx/MeasureTextEx for single-line ASCII text
+void TextLayoutBuild(TextLayout *layout, Font font, const char *text, float fontSize, float spacing){
+    float scale = fontSize/font.baseSize;
+    float pad = (float)font.glyphPadding;
+    float x = 0;
+    int chars = 0;
+
+    layout->glyphCount = 0;
+    for(const char *c = text; *c; c++, chars++){
+        int index = GetGlyphIndex(font, (unsigned char)*c);
+        Rectangle rec = font.recs[index];
+        GlyphInfo glyph = font.glyphs[index];
+
+        if(*c != ' ' && *c != '\t'){
+            if(layout->glyphCount == TEXT_MAX_GLYPHS){
+                TraceLog(LOG_WARNING, "TEXT: \"%s\" cut to %d glyphs", text, TEXT_MAX_GLYPHS);
+                break;
+            }
+            int n = layout->glyphCount++;
+            layout->src[n] = (Rectangle){ rec.x - pad, rec.y - pad, rec.width + 2*pad, rec.height + 2*pad };
+            layout->dst[n] = (Rectangle){ x + glyph.offsetX*scale - pad*scale, glyph.offsetY*scale - pad*scale,
+                                          (rec.width + 2*pad)*scale, (rec.height + 2*pad)*scale };
+        }
+        x += (glyph.advanceX == 0 ? rec.width : glyph.advanceX)*scale + spacing;
+    }
+
+    layout->size = (Vector2){ chars > 0 ? x - spacing : 0, fontSize };
+    textLayoutBuilds++;
+}
+
+void DrawTextLayout(Font font, const TextLayout *layout, Vector2 pos, Color tint){
+    RenderStatsTrack(font.texture.id);
+    for(int i=0;i<layout->glyphCount;i++){
+        Rectangle dst = layout->dst[i];
+        dst.x += pos.x;
+        dst.y += pos.y;
+        DrawTexturePro(font.texture, layout->src[i], dst, (Vector2){0,0}, 0.0f, tint);
+    }
+}
+
+// ------------------- Cached Numbers -------------------
+const TextLayout *CachedTextGet(CachedText *text, Font font, int value){
+    if(!text->valid || text->value != value){
+        TextLayoutBuild(&text->layout, font, TextFormat(text->format, value), text->fontSize, text->spacing);
+        text->value = value;
+        text->valid = true;
+    }
+    return &text->layout;
+}
+
+void CachedTextInvalidate(CachedText *text){
+    text->valid = false;
+}
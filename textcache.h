@@ -0,0 +1,40 @@
+#ifndef TEXTCACHE_H
+#define TEXTCACHE_H
+
+// Retained text: a string is glyph-indexed and measured once into a list of quads,
+// and drawing it afterwards is just those quads. Numbers are only re-laid out when
+// their value changes. ASCII only: each byte is one glyph, nothing decodes UTF-8.
+
+#include "raylib.h"
+
+// Quads, not characters: spaces take none. The longest string laid out is a hole
+// indicator with every team's key, 8 x "RIGHT_CONTROL" and 7 dashes.
+#define TEXT_MAX_GLYPHS 112
+
+typedef struct {
+    Rectangle src[TEXT_MAX_GLYPHS];     // glyph rects in the font texture
+    Rectangle dst[TEXT_MAX_GLYPHS];     // relative to the text origin
+    int glyphCount;
+    Vector2 size;                       // same as MeasureTextEx
+} TextLayout;
+
+// A label with one %d that follows a changing value
+typedef struct {
+    const char *format;
+    float fontSize;
+    float spacing;
+    int value;
+    bool valid;
+    TextLayout layout;
+} CachedText;
+
+extern int textLayoutBuilds;    // layouts built since start, to confirm the cache holds
+
+void TextLayoutBuild(TextLayout *layout, Font font, const char *text, float fontSize, float spacing);
+void DrawTextLayout(Font font, const TextLayout *layout, Vector2 pos, Color tint);
+
+// Rebuilds the layout only if value changed (or the font did, via CachedTextInvalidate)
+const TextLayout *CachedTextGet(CachedText *text, Font font, int value);
+void CachedTextInvalidate(CachedText *text);
+
+#endif
@@ -0,0 +1,245 @@
+// Rendering stress benchmark: drives the game's own update and DrawGame()
+// through scripted scenarios in a hidden window and writes frame-time
+// statistics and heap allocation counts as JSON. Runs on a GPU-less box under
+// Mesa's software rasterizer (llvmpipe), where present times are the cost of
+// actually filling the pixels:
+//
+//   cc -O2 -I. tools/bench.c game.c atlas.c textcache.c loader.c sim.c pack.c input.c profiler.c board.c net.c replay.c audio.c render.c particles.c telemetry.c history.c arena.c -lraylib -lm -lpthread -o bench
+//   (or the bench target of the CMake build)
+//   xvfb-run -a env LIBGL_ALWAYS_SOFTWARE=1 ./bench [--frames N] [--warmup N] [--scenario NAME]
+//                                                   [--holes N] [--window WxH] [--render-scale S] [--json F]
+//
+// Run from the repo root (it loads assets/ like the game). Each scenario runs
+// on a virtual clock, one simulation tick per frame, so the work per frame
+// doesn't depend on how fast the machine draws. Allocations are counted by
+// wrapping malloc/calloc/realloc, on glibc only (elsewhere they read -1); the
+// count includes every thread, the driver's too.
+
+#include "game.h"
+#include "atlas.h"
+#include "loader.h"
+#include "audio.h"
+#include "render.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// ------------------- Allocation Counter -------------------
+#if defined(__GLIBC__)
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *p, size_t size);
+
+static atomic_long allocations;
+
+void *malloc(size_t size){
+    atomic_fetch_add_explicit(&allocations, 1, memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size){
+    atomic_fetch_add_explicit(&allocations, 1, memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *p, size_t size){
+    atomic_fetch_add_explicit(&allocations, 1, memory_order_relaxed);
+    return __libc_realloc(p, size);
+}
+
+static long AllocationCount(void){ return atomic_load_explicit(&allocations, memory_order_relaxed); }
+#else
+static long AllocationCount(void){ return -1; }
+#endif
+
+static double NowSeconds(void){
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+static int CompareDoubles(const void *a, const void *b){
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// ------------------- Scenarios -------------------
+// Menu and victory are retained screens, so after the first frame they mostly
+// measure the present; the two in-game ones compose every frame.
+static SimRules fullBoardRules;
+static float defaultSpawnIdle;
+
+static void StartMatch(void){
+    InitGame();
+    SimInit(match, 1);      // same moles every run
+    SetState(STATE_GAME);
+}
+
+static void SetupMenu(void){ SetState(STATE_MENU); }
+
+// Every hole up at once and staying up: moles pop a tick after they empty
+static void SetupFullBoard(void){
+    fullBoardRules = simDefaultRules;
+    fullBoardRules.moleLifetime = 1e6f;
+    board.holes.spawnMeanIdle = 0.0f;
+    match->rules = &fullBoardRules;
+    StartMatch();
+}
+
+static void SetupHits(void){
+    board.holes.spawnMeanIdle = defaultSpawnIdle;
+    match->rules = &simDefaultRules;
+    StartMatch();
+}
+
+static void SetupVictory(void){ SetState(STATE_VICTORY); }
+
+// Both teams strike every frame, on holes walking round the board in step
+static void ScriptHits(int frame, double now){
+    int holes = board.holes.holeCount;
+    InputPush((InputEvent){ now, frame % holes, 0 });
+    if(bindings.teamCount > 1) InputPush((InputEvent){ now, (frame + holes/2) % holes, 1 });
+}
+
+typedef struct {
+    const char *name;
+    void (*setup)(void);
+    void (*script)(int frame, double now);     // scripted input, may be NULL
+} Scenario;
+
+static const Scenario scenarios[] = {
+    { "menu_idle", SetupMenu, NULL },
+    { "full_board", SetupFullBoard, NULL },
+    { "alternating_hits", SetupHits, ScriptHits },
+    { "victory", SetupVictory, NULL },
+};
+#define SCENARIO_COUNT ((int)(sizeof(scenarios)/sizeof(scenarios[0])))
+
+// ------------------- Report -------------------
+enum { PHASE_UPDATE, PHASE_DRAW, PHASE_PRESENT, PHASE_FRAME, PHASE_COUNT };
+static const char *const phaseNames[PHASE_COUNT] = { "update_ms", "draw_ms", "present_ms", "frame_ms" };
+
+static void WriteStats(FILE *out, const char *name, double *samples, int count, bool last){
+    qsort(samples, count, sizeof(double), CompareDoubles);
+    double sum = 0;
+    for(int i=0;i<count;i++) sum += samples[i];
+    fprintf(out, "      \"%s\": {\"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f}%s\n", name,
+            sum/count*1e3, samples[count/2]*1e3, samples[count*95/100]*1e3, samples[count*99/100]*1e3,
+            samples[count - 1]*1e3, last ? "" : ",");
+}
+
+// ------------------- Main -------------------
+int main(int argc, char **argv){
+    int frames = 1200, warmup = 60, holes = 0;
+    int windowWidth = SCREEN_WIDTH, windowHeight = SCREEN_HEIGHT;
+    float scale = 1.0f;
+    const char *only = NULL, *jsonPath = NULL;
+    for(int i=1;i<argc;i++){
+        if(strcmp(argv[i], "--frames") == 0 && i+1 < argc) frames = atoi(argv[++i]);
+        else if(strcmp(argv[i], "--warmup") == 0 && i+1 < argc) warmup = atoi(argv[++i]);
+        else if(strcmp(argv[i], "--scenario") == 0 && i+1 < argc) only = argv[++i];
+        else if(strcmp(argv[i], "--holes") == 0 && i+1 < argc) holes = atoi(argv[++i]);
+        else if(strcmp(argv[i], "--window") == 0 && i+1 < argc) sscanf(argv[++i], "%dx%d", &windowWidth, &windowHeight);
+        else if(strcmp(argv[i], "--render-scale") == 0 && i+1 < argc) scale = (float)atof(argv[++i]);
+        else if(strcmp(argv[i], "--json") == 0 && i+1 < argc) jsonPath = argv[++i];
+    }
+    if(frames < 1 || warmup < 0) return 1;
+    FILE *out = jsonPath ? fopen(jsonPath, "w") : stdout;
+    if(!out){
+        fprintf(stderr, "BENCH: cannot write %s\n", jsonPath);
+        return 1;
+    }
+
+    // ------------------- Setup -------------------
+    // As main.c, minus the options that touch the network or files
+    persistMatches = false;
+    if(holes > 0) BoardGenerate(&board, holes, SCREEN_WIDTH, SCREEN_HEIGHT);
+    else BoardDefault(&board);
+    HitGridBuild(&hitGrid, &board, 128);
+    defaultSpawnIdle = board.holes.spawnMeanIdle;
+    BindingsDefault(&bindings);
+    InputSetBindings(&bindings);
+    InputSetHitGrid(&hitGrid);
+    LayoutArenas();
+
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(windowWidth, windowHeight, "bench");
+    InitEffects();
+    InitAudioDevice();
+    SetTargetFPS(0);
+    RenderInit(SCREEN_WIDTH, SCREEN_HEIGHT, scale, scale, 1.0/60.0);
+    LoaderScaleTextures(renderScaler.maxScale);
+    LoadAssets();
+    while(!LoaderDone()) LoaderPump(0.05);
+    OnMenuAssetsReady();
+    OnGameAssetsReady();
+    // Music decodes on its own thread; let it finish so it isn't counted
+    for(double until = GetTime() + 10.0; MusicNeedsUpdates() && GetTime() < until;){
+        MusicUpdate();
+        WaitTime(0.01);
+    }
+
+    // ------------------- Run -------------------
+    fprintf(out, "{\n  \"window\": [%d, %d],\n  \"render_scale\": %.2f,\n  \"holes\": %d,\n  \"frames\": %d,\n"
+                 "  \"warmup\": %d,\n  \"allocations_counted\": %s,\n  \"scenarios\": [\n",
+            windowWidth, windowHeight, renderScaler.scale, board.holes.holeCount, frames, warmup,
+            AllocationCount() >= 0 ? "true" : "false");
+
+    double *samples[PHASE_COUNT];
+    for(int p=0;p<PHASE_COUNT;p++) samples[p] = malloc(frames*sizeof(double));
+    bool gamePaused = false, first = true;
+    Vector2 mousePos = { 10, 10 };      // off every button
+    for(int s=0;s<SCENARIO_COUNT;s++){
+        const Scenario *sc = &scenarios[s];
+        if(only && strcmp(only, sc->name) != 0) continue;
+        sc->setup();
+        double now = arenas[0].simClock;
+        long allocs = 0, drawCalls = 0;
+        int composes = 0;
+
+        for(int f=-warmup;f<frames;f++){
+            now += SIM_DT;
+            long allocsBefore = AllocationCount();
+            double t0 = NowSeconds();
+            InputFrameClear();
+            if(sc->script) sc->script(f + warmup, now);
+            UpdateGameState(now, mousePos, &gamePaused);
+            double t1 = NowSeconds();
+            bool composed = DrawGame(mousePos);
+            int calls = renderStats.drawCalls;
+            DrawOverlays();
+            double t2 = NowSeconds();
+            EndDrawing();
+            double t3 = NowSeconds();
+            MusicUpdate();
+            if(f < 0) continue;
+
+            samples[PHASE_UPDATE][f] = t1 - t0;
+            samples[PHASE_DRAW][f] = t2 - t1;
+            samples[PHASE_PRESENT][f] = t3 - t2;
+            samples[PHASE_FRAME][f] = t3 - t0;
+            allocs += AllocationCount() - allocsBefore;
+            drawCalls += calls;
+            composes += composed;
+        }
+
+        fprintf(out, "%s    {\n      \"name\": \"%s\",\n      \"composed_frames\": %d,\n      \"draw_calls\": %.1f,\n",
+                first ? "" : ",\n", sc->name, composes, (double)drawCalls/frames);
+        if(AllocationCount() >= 0) fprintf(out, "      \"allocations\": %ld,\n      \"allocations_per_frame\": %.3f,\n", allocs, (double)allocs/frames);
+        else fprintf(out, "      \"allocations\": -1,\n      \"allocations_per_frame\": -1,\n");
+        for(int p=0;p<PHASE_COUNT;p++) WriteStats(out, phaseNames[p], samples[p], frames, p == PHASE_COUNT - 1);
+        fprintf(out, "    }");
+        first = false;
+    }
+    fprintf(out, "\n  ]\n}\n");
+    if(out != stdout) fclose(out);
+    for(int p=0;p<PHASE_COUNT;p++) free(samples[p]);
+
+    GameShutdown();
+    CloseAudioDevice();
+    CloseWindow();
+    return 0;
+}
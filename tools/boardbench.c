@@ -0,0 +1,119 @@
+// Board scaling benchmark: per-tick mole update cost and per-click hit-test cost
+// as the hole count grows. Spawn rates are scaled so the number of moles on
+// screen stays about the same as on the 5-hole board; the SoA store only touches
+// those, so its cost should stay flat while a per-hole scan grows with the board.
+//
+//   cc -O2 -I. tools/boardbench.c sim.c board.c -lm -o boardbench
+//   ./boardbench [--ticks N]
+
+#include "sim.h"
+#include "board.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double NowSeconds(void){
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+// ------------------- Per-Hole Scan Baseline -------------------
+// The old array-of-structs layout, updated by looking at every hole each tick
+typedef struct {
+    SimVec2 pos;
+    bool isVisible;
+    int type;
+    float timer;
+    bool isHit;
+} ScanMole;
+
+static double ScanTicks(const SimBoard *board, long ticks, float visibleChance){
+    static ScanMole moles[SIM_MAX_HOLES];
+    SimRng rng;
+    SimRngSeed(&rng, 7, 3);
+    for(int i=0;i<board->holeCount;i++){
+        moles[i] = (ScanMole){ board->pos[i], SimRngFloat(&rng) < visibleChance, MOLE_NORMAL, SimRngFloat(&rng), false };
+    }
+    double start = NowSeconds();
+    for(long t=0;t<ticks;t++){
+        for(int i=0;i<board->holeCount;i++){
+            ScanMole *m = &moles[i];
+            if(!m->isVisible) continue;
+            m->timer -= SIM_DT;
+            if(m->timer <= 0) m->timer += 1.0f;   // stand-in for hide + respawn elsewhere
+        }
+    }
+    return NowSeconds() - start;
+}
+
+// ------------------- Benchmarks -------------------
+static volatile int sink;
+
+int main(int argc, char **argv){
+    long ticks = 200000;
+    for(int i=1;i<argc;i++){
+        if(!strcmp(argv[i], "--ticks") && i+1<argc) ticks = strtol(argv[++i], NULL, 10);
+        else{
+            fprintf(stderr, "usage: %s [--ticks N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    static const int sizes[] = { 5, 20, 50, 100, 250, 500, 1000 };
+    static BoardLayout layout;
+    static Match match;
+    const long queries = 1000000;
+
+    printf("%6s %10s %14s %14s %14s %14s\n", "holes", "on screen", "soa ns/tick", "scan ns/tick", "grid ns/click", "linear ns/click");
+    for(size_t n=0;n<sizeof(sizes)/sizeof(sizes[0]);n++){
+        int holes = sizes[n];
+        BoardGenerate(&layout, holes, 1920, 1080);
+        layout.holes.spawnMeanIdle = simDefaultBoard.spawnMeanIdle*holes/simDefaultBoard.holeCount;
+
+        // Simulation: whole matches back to back, no input
+        memset(&match, 0, sizeof(match));
+        match.board = &layout.holes;
+        SimInit(&match, 1);
+        double activeSum = 0;
+        double start = NowSeconds();
+        for(long t=0;t<ticks;t++){
+            if(SimIsOver(&match)) SimInit(&match, (uint64_t)t);
+            SimStep(&match, NULL);
+            activeSum += match.moles.activeCount;
+        }
+        double simTime = NowSeconds() - start;
+        double active = activeSum/ticks;
+
+        double scanTime = ScanTicks(&layout.holes, ticks, (float)(active/holes));
+
+        // Hit testing: random clicks, grid vs checking every button
+        HitGrid grid;
+        HitGridBuild(&grid, &layout, 128);
+        SimRng rng;
+        SimRngSeed(&rng, 11, 5);
+        int team;
+        start = NowSeconds();
+        for(long q=0;q<queries;q++) sink += HitGridQuery(&grid, SimRngFloat(&rng)*1920, SimRngFloat(&rng)*1080, &team);
+        double gridTime = NowSeconds() - start;
+
+        SimRngSeed(&rng, 11, 5);
+        start = NowSeconds();
+        for(long q=0;q<queries;q++){
+            float x = SimRngFloat(&rng)*1920, y = SimRngFloat(&rng)*1080;
+            int hit = -1;
+            for(int id=0;id<holes*2 && hit<0;id++){
+                const BoardRect *r = (id & 1) ? &layout.blueButtons[id >> 1] : &layout.redButtons[id >> 1];
+                if(x >= r->x && x <= r->x + r->width && y >= r->y && y <= r->y + r->height) hit = id >> 1;
+            }
+            sink += hit;
+        }
+        double linearTime = NowSeconds() - start;
+        HitGridFree(&grid);
+
+        printf("%6d %10.2f %14.1f %14.1f %14.1f %14.1f\n", holes, active,
+            simTime*1e9/ticks, scanTime*1e9/ticks, gridTime*1e9/queries, linearTime*1e9/queries);
+    }
+    return 0;
+}
@@ -0,0 +1,132 @@
+// Headless match runner: plays whole matches with bot players, no window or audio device.
+// Same seed -> same bots -> same final scores, so it doubles as a regression check.
+//
+//   cc -O2 -I. tools/headless.c sim.c replay.c -lm -o headless
+//   ./headless --matches 10000 --seed 42
+//   ./headless --matches 1 --save-replay match.replay     (check it with tools/replay.c)
+
+#include "sim.h"
+#include "replay.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// ------------------- Bot Player -------------------
+typedef struct {
+    SimRng rng;
+    float reactionMin;      // seconds from pop to strike
+    float reactionMax;
+    float avoidBomber;      // chance of holding back on a bomber/empty mole
+    float clock;
+    bool planned[SIM_MAX_HOLES];
+    float strikeAt[SIM_MAX_HOLES];
+} Bot;
+
+typedef struct { Bot red; Bot blue; SimRng order; Replay *record; } BotPair;
+
+static void InitBot(Bot *bot, uint64_t seed, uint64_t stream){
+    memset(bot, 0, sizeof(*bot));
+    SimRngSeed(&bot->rng, seed, stream);
+    bot->reactionMin = 0.25f;
+    bot->reactionMax = 0.9f;
+    bot->avoidBomber = 0.7f;
+}
+
+static void BotThink(Bot *bot, const Match *match, SimInput *input, int team){
+    const SimMoles *m = &match->moles;
+    bot->clock += SIM_DT;
+    for(int i=0;i<match->board->holeCount;i++){
+        if(!SimMoleVisible(m, i)){ bot->planned[i] = false; continue; }
+        if(SimMoleHit(m, i)) continue;
+
+        if(!bot->planned[i]){
+            bot->planned[i] = true;
+            bool bad = (m->type[i] == MOLE_BOMBER || m->type[i] == MOLE_EMPTY);
+            if(bad && SimRngFloat(&bot->rng) < bot->avoidBomber) bot->strikeAt[i] = 1e9f;
+            else bot->strikeAt[i] = bot->clock + bot->reactionMin + (bot->reactionMax - bot->reactionMin)*SimRngFloat(&bot->rng);
+        }
+        if(bot->clock >= bot->strikeAt[i]){
+            SimInputAdd(input, i, team);
+            bot->strikeAt[i] = 1e9f;
+        }
+    }
+}
+
+// Hits apply in input order and only the first on a mole scores, so a coin flip
+// each tick decides who goes first; a fixed order would favor that seat
+static void PollBots(void *user, const Match *match, SimInput *input){
+    BotPair *bots = user;
+    bool redFirst = SimRngNext(&bots->order) & 1;
+    BotThink(redFirst ? &bots->red : &bots->blue, match, input, redFirst ? 0 : 1);
+    BotThink(redFirst ? &bots->blue : &bots->red, match, input, redFirst ? 1 : 0);
+    for(int i=0;bots->record && i<input->count;i++) ReplayRecordHit(bots->record, match, input->hits[i].hole, input->hits[i].team);
+}
+
+// ------------------- Timing -------------------
+static double NowSeconds(void){
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+// ------------------- Main -------------------
+int main(int argc, char **argv){
+    long matches = 1000;
+    uint64_t seed = 1;
+    bool verbose = false;
+    const char *replayPath = NULL;
+
+    for(int i=1;i<argc;i++){
+        if(!strcmp(argv[i], "--matches") && i+1<argc) matches = strtol(argv[++i], NULL, 10);
+        else if(!strcmp(argv[i], "--seed") && i+1<argc) seed = strtoull(argv[++i], NULL, 10);
+        else if(!strcmp(argv[i], "--verbose")) verbose = true;
+        else if(!strcmp(argv[i], "--save-replay") && i+1<argc) replayPath = argv[++i];
+        else{
+            fprintf(stderr, "usage: %s [--matches N] [--seed S] [--verbose] [--save-replay F]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    long redWins = 0, blueWins = 0, draws = 0;
+    uint64_t checksum = 1469598103934665603ULL;   // FNV-1a over every final score
+
+    static Replay replay;     // of the first match
+    double start = NowSeconds();
+    for(long n=0;n<matches;n++){
+        uint64_t matchSeed = seed + (uint64_t)n;
+        Match match = {0};
+        BotPair bots;
+        InitBot(&bots.red, matchSeed, 1);
+        InitBot(&bots.blue, matchSeed, 2);
+        SimRngSeed(&bots.order, matchSeed, 3);
+        bots.record = (replayPath && n == 0) ? &replay : NULL;
+        SimInputSource source = { PollBots, &bots };
+
+        SimInit(&match, matchSeed);
+        if(bots.record) ReplayBegin(&replay, &match, matchSeed);
+        SimRunMatch(&match, &source);
+        if(bots.record){
+            ReplayEnd(&replay, &match);
+            ReplaySave(&replay, replayPath);
+        }
+
+        int winner = SimWinner(&match);
+        if(winner == 0) redWins++;
+        else if(winner == 1) blueWins++;
+        else draws++;
+
+        for(int k=0;k<2;k++){
+            checksum ^= (uint32_t)match.scores[k];
+            checksum *= 1099511628211ULL;
+        }
+        if(verbose) printf("match %ld seed %llu: red %d blue %d\n", n, (unsigned long long)matchSeed, match.scores[0], match.scores[1]);
+        SimFree(&match);
+    }
+    double elapsed = NowSeconds() - start;
+
+    printf("matches: %ld  red wins: %ld  blue wins: %ld  draws: %ld\n", matches, redWins, blueWins, draws);
+    printf("checksum: %016llx\n", (unsigned long long)checksum);
+    printf("elapsed: %.3f s  (%.0f matches/s)\n", elapsed, elapsed > 0 ? matches/elapsed : 0.0);
+    return 0;
+}
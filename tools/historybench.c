@@ -0,0 +1,117 @@
+// Match-history benchmark: appends N synthetic matches to a scratch log (default
+// 1M matches of two teams, drawn from 100 names), reopens it, and times the
+// queries the menu and victory screens make. Then tears the last write the way
+// a crash would and checks the reopened log lost only that match.
+//
+//   cc -O2 -I. tools/historybench.c history.c sim.c -lm -lpthread -o historybench
+//   ./historybench [--matches N] [--teams N] [--players N] [--path F] [--keep]
+
+#include "history.h"
+#include "sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double NowSeconds(void){
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+static void RemoveFiles(const char *path){
+    char other[300];
+    remove(path);
+    snprintf(other, sizeof(other), "%s.idx", path);
+    remove(other);
+}
+
+// ------------------- Main -------------------
+int main(int argc, char **argv){
+    int matches = 1000000, teams = 2, players = 100;
+    const char *path = "historybench.log";
+    bool keep = false;
+    for(int i=1;i<argc;i++){
+        if(strcmp(argv[i], "--matches") == 0 && i+1 < argc) matches = atoi(argv[++i]);
+        else if(strcmp(argv[i], "--teams") == 0 && i+1 < argc) teams = atoi(argv[++i]);
+        else if(strcmp(argv[i], "--players") == 0 && i+1 < argc) players = atoi(argv[++i]);
+        else if(strcmp(argv[i], "--path") == 0 && i+1 < argc) path = argv[++i];
+        else if(strcmp(argv[i], "--keep") == 0) keep = true;
+    }
+    if(matches < 1 || teams < 1 || teams > SIM_MAX_TEAMS || players < teams) return 1;
+
+    static char names[1000][HISTORY_NAME_MAX];
+    if(players > 1000) players = 1000;
+    for(int p=0;p<players;p++) snprintf(names[p], HISTORY_NAME_MAX, "player%03d", p % 1000);
+
+    // ------------------- Append -------------------
+    RemoveFiles(path);
+    if(!HistoryOpen(path)) return 1;
+    SimRng rng;
+    SimRngSeed(&rng, 1, 0);
+    double start = NowSeconds();
+    for(int m=0;m<matches;m++){
+        const char *who[SIM_MAX_TEAMS];
+        int scores[SIM_MAX_TEAMS];
+        int best = 0;
+        for(int t=0;t<teams;t++){
+            who[t] = names[(m*teams + t) % players];
+            scores[t] = SimRngRange(&rng, -20, 200);
+            if(scores[t] > scores[best]) best = t;
+        }
+        int winner = best;
+        for(int t=0;t<teams;t++) if(t != best && scores[t] == scores[best]) winner = -1;
+        HistoryAddMatch(teams, who, scores, winner);
+    }
+    double queuedAt = NowSeconds();
+    HistoryClose();
+    double end = NowSeconds();
+    printf("append:  %d matches queued in %.3f s (%.2f us each on the game thread), written in %.3f s\n",
+           matches, queuedAt - start, (queuedAt - start)*1e6/matches, end - start);
+
+    // ------------------- Queries -------------------
+    start = NowSeconds();
+    if(!HistoryOpen(path)) return 1;
+    printf("reopen:  %.3f ms\n", (NowSeconds() - start)*1e3);
+
+    const int runs = 200;
+    HistoryRecord top[10], recent[20];
+    HistoryTeam team;
+    int topCount = 0, recentCount = 0;
+    start = NowSeconds();
+    for(int i=0;i<runs;i++) topCount = HistoryTopScores(top, 10);
+    printf("top 10:    %8.1f us\n", (NowSeconds() - start)*1e6/runs);
+    start = NowSeconds();
+    for(int i=0;i<runs;i++) HistoryTeamStats(names[i % players], &team);
+    printf("team:      %8.1f us\n", (NowSeconds() - start)*1e6/runs);
+    start = NowSeconds();
+    for(int i=0;i<runs;i++) recentCount = HistoryRecent(recent, 20);
+    printf("recent 20: %8.1f us\n", (NowSeconds() - start)*1e6/runs);
+
+    // ------------------- Checks -------------------
+    bool ok = HistoryMatchCount() == (uint32_t)matches && topCount == (matches*teams < 10 ? matches*teams : 10);
+    for(int i=1;i<topCount;i++) ok = ok && top[i-1].score >= top[i].score;
+    ok = ok && recentCount > 0 && recent[0].match == (uint32_t)matches && recent[0].last;
+    uint64_t played = 0;
+    for(int p=0;p<players;p++) if(HistoryTeamStats(names[p], &team)) played += team.matches;
+    ok = ok && played == (uint64_t)matches*teams;
+    printf("best: %s %d in match %u; %s has won %u of %u\n", top[0].team, top[0].score, top[0].match,
+           team.team, team.wins, team.matches);
+    HistoryClose();
+
+    // Half a record past the last match, as a crash mid-write leaves it
+    FILE *f = fopen(path, "ab");
+    if(f){
+        HistoryRecord torn = recent[0];
+        fwrite(&torn, sizeof(torn)/2, 1, f);
+        fclose(f);
+    }
+    if(HistoryOpen(path)){
+        ok = ok && HistoryMatchCount() == (uint32_t)matches;
+        HistoryClose();
+    }else ok = false;
+
+    printf("%s\n", ok ? "checks passed" : "CHECKS FAILED");
+    if(!keep) RemoveFiles(path);
+    return ok ? 0 : 1;
+}
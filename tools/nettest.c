@@ -0,0 +1,106 @@
+// Loopback multiplayer test: one server and two bot clients over real UDP on
+// 127.0.0.1, with the link conditioner adding latency, jitter and loss. Time is
+// virtual (1 ms steps), so a whole match runs in a moment. Fails unless every
+// client ends on exactly the server's final state.
+//
+//   cc -O2 -I. tools/nettest.c net.c sim.c -lm -o nettest
+//   ./nettest --latency 60 --jitter 20 --loss 5
+
+#include "net.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CLIENTS 2
+
+// ------------------- Bot Player -------------------
+typedef struct {
+    SimRng rng;
+    double strikeAt[SIM_MAX_HOLES];
+    bool planned[SIM_MAX_HOLES];
+} Bot;
+
+static void BotThink(Bot *bot, NetClient *client, double now){
+    const Match *m = client->match;
+    if(!client->live || SimIsOver(m)) return;
+    for(int i=0;i<m->board->holeCount;i++){
+        if(!SimMoleVisible(&m->moles, i)){ bot->planned[i] = false; continue; }
+        if(SimMoleHit(&m->moles, i)) continue;
+        if(!bot->planned[i]){
+            bot->planned[i] = true;
+            bot->strikeAt[i] = now + 0.2 + 0.6*SimRngFloat(&bot->rng);
+        }
+        if(now >= bot->strikeAt[i]){
+            NetClientHit(client, i);
+            bot->strikeAt[i] = 1e9;
+        }
+    }
+}
+
+// ------------------- Main -------------------
+int main(int argc, char **argv){
+    NetConditions conditions = {0};
+    uint16_t port = NET_DEFAULT_PORT + 100;
+
+    for(int i=1;i<argc;i++){
+        if(!strcmp(argv[i], "--latency") && i+1<argc) conditions.latency = atof(argv[++i])/1000.0;
+        else if(!strcmp(argv[i], "--jitter") && i+1<argc) conditions.jitter = atof(argv[++i])/1000.0;
+        else if(!strcmp(argv[i], "--loss") && i+1<argc) conditions.loss = (float)atof(argv[++i])/100.0f;
+        else if(!strcmp(argv[i], "--port") && i+1<argc) port = (uint16_t)atoi(argv[++i]);
+        else{
+            fprintf(stderr, "usage: %s [--latency ms] [--jitter ms] [--loss pct] [--port N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    static NetServer server;
+    static NetClient clients[CLIENTS];
+    static Match matches[CLIENTS];
+    static Bot bots[CLIENTS];
+    if(!NetServerStart(&server, port, CLIENTS, &conditions)) return 1;
+    for(int c=0;c<CLIENTS;c++){
+        if(!NetClientConnect(&clients[c], &matches[c], "127.0.0.1", port, c, &conditions)) return 1;
+        SimRngSeed(&bots[c].rng, 99, (uint64_t)c + 1);
+    }
+
+    // Until a while after the round ends, so the last snapshots get through
+    double now = 0, overAt = -1;
+    for(;now < 300.0;now += 0.001){
+        NetServerUpdate(&server, now);
+        for(int c=0;c<CLIENTS;c++){
+            BotThink(&bots[c], &clients[c], now);
+            NetClientUpdate(&clients[c], now);
+        }
+        if(overAt < 0 && server.matchId && !server.running) overAt = now;
+        if(overAt >= 0 && now > overAt + 2.0) break;
+    }
+    if(overAt < 0){
+        fprintf(stderr, "match never finished\n");
+        return 1;
+    }
+
+    uint8_t want[NET_MAX_SNAPSHOT], got[NET_MAX_SNAPSHOT];
+    size_t wantSize = SimSave(&server.match, want, sizeof(want));
+    bool converged = true;
+    printf("server: tick %u  scores %d:%d  sent %llu bytes in %u packets (%u dropped)\n", server.match.tick,
+           server.match.scores[0], server.match.scores[1],
+           (unsigned long long)server.socket.bytesSent, server.socket.packetsSent, server.socket.packetsLost);
+
+    for(int c=0;c<CLIENTS;c++){
+        NetClient *cl = &clients[c];
+        size_t gotSize = SimSave(cl->match, got, sizeof(got));
+        bool same = gotSize == wantSize && !memcmp(got, want, wantSize);
+        converged &= same;
+        const NetStats *st = &cl->stats;
+        printf("client %d: %s  snapshots %u (%u full)  avg %.0f bytes  up %.1f kB/s  down %.1f kB/s\n", c,
+               same ? "converged" : "DIVERGED", st->snapshots, st->fullSnapshots,
+               st->snapshots ? (double)st->snapshotBytes/st->snapshots : 0.0,
+               cl->socket.bytesSent/now/1000.0, cl->socket.bytesReceived/now/1000.0);
+        printf("          rtt p50 %.1f ms  p95 %.1f ms  rollbacks %u  resimulated ticks %u\n",
+               NetRttPercentile(st, 0.5f), NetRttPercentile(st, 0.95f), st->rollbacks, st->resimulatedTicks);
+    }
+
+    NetServerStop(&server);
+    for(int c=0;c<CLIENTS;c++) NetClientDisconnect(&clients[c]);
+    return converged ? 0 : 1;
+}
@@ -0,0 +1,193 @@
+// Asset packer: bakes assets/ into one assets.pack the game can map and upload directly.
+// Decodes every PNG/JPEG, WAV and OGG once here so the game never has to.
+//
+//   cc -O2 -I. tools/packer.c atlas.c -lraylib -lm -o packer
+//   ./packer [assets.pack]        (run from the repository root)
+
+#include "raylib.h"
+#include "atlas.h"
+#include "pack.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_ENTRIES 64
+
+// ------------------- Entry List -------------------
+typedef struct {
+    PackEntry entry;
+    void *data;
+} PendingEntry;
+
+static PendingEntry pending[MAX_ENTRIES];
+static int pendingCount = 0;
+
+static void AddEntry(const char *name, PackKind kind, const uint32_t params[5], const void *data, size_t size){
+    if(pendingCount >= MAX_ENTRIES || strlen(name) >= PACK_NAME_MAX){
+        fprintf(stderr, "packer: cannot add %s\n", name);
+        exit(1);
+    }
+    PendingEntry *p = &pending[pendingCount++];
+    memset(p, 0, sizeof(*p));
+    strcpy(p->entry.name, name);
+    p->entry.kind = kind;
+    if(params) memcpy(p->entry.params, params, sizeof(p->entry.params));
+    p->entry.size = size;
+    p->data = malloc(size ? size : 1);
+    memcpy(p->data, data, size);
+}
+
+// Bytes of a full mip chain, laid out the way raylib's Image keeps it
+static size_t MipChainSize(int width, int height, int mipmaps, int format){
+    size_t size = 0;
+    for(int i=0;i<mipmaps;i++){
+        size += GetPixelDataSize(width, height, format);
+        width = (width > 1) ? width/2 : 1;
+        height = (height > 1) ? height/2 : 1;
+    }
+    return size;
+}
+
+static void AddImage(const char *name, Image image){
+    uint32_t params[5] = { image.width, image.height, image.mipmaps, image.format, 0 };
+    AddEntry(name, PACK_TEXTURE, params, image.data, MipChainSize(image.width, image.height, image.mipmaps, image.format));
+}
+
+// ------------------- Asset Kinds -------------------
+// Opaque backgrounds: RGB888 with mips (lower levels serve reduced render scales)
+static void AddBackground(const char *path){
+    Image image = LoadImage(path);
+    if(!image.data){ fprintf(stderr, "packer: cannot load %s\n", path); exit(1); }
+    ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8);
+    ImageMipmaps(&image);
+    AddImage(path, image);
+    UnloadImage(image);
+}
+
+static void AddSpriteAtlas(void){
+    AtlasImage atlas;
+    if(!AtlasBuildImage(&atlas, SPRITE_MASK_ALL)) exit(1);
+
+    PackSprite sprites[SPRITE_COUNT];
+    for(int i=0;i<SPRITE_COUNT;i++){
+        Rectangle r = atlas.sprites[i].rect;
+        sprites[i] = (PackSprite){ atlas.sprites[i].page, r.x, r.y, r.width, r.height };
+    }
+    uint32_t params[5] = { SPRITE_COUNT, atlas.pageCount, 0, 0, 0 };
+    AddEntry("atlas", PACK_ATLAS, params, sprites, sizeof(sprites));
+
+    for(int i=0;i<atlas.pageCount;i++){
+        ImageFormat(&atlas.pages[i], PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        AddImage(TextFormat("atlas.page%d", i), atlas.pages[i]);
+    }
+    UnloadAtlasImage(&atlas);
+}
+
+// Same parameters LoadFont() uses for a TTF, rasterized here instead of at startup
+static void AddFont(const char *path){
+    const int size = 32, count = 95, padding = 4;
+    int dataSize = 0;
+    unsigned char *data = LoadFileData(path, &dataSize);
+    GlyphInfo *glyphs = data ? LoadFontData(data, dataSize, size, NULL, count, FONT_DEFAULT) : NULL;
+    if(!glyphs){ fprintf(stderr, "packer: cannot load font %s\n", path); exit(1); }
+
+    Rectangle *recs = NULL;
+    Image atlas = GenImageFontAtlas(glyphs, &recs, count, size, padding, 0);
+
+    PackGlyph table[95];
+    for(int i=0;i<count;i++){
+        table[i] = (PackGlyph){ glyphs[i].value, glyphs[i].offsetX, glyphs[i].offsetY, glyphs[i].advanceX,
+                                recs[i].x, recs[i].y, recs[i].width, recs[i].height };
+    }
+    uint32_t params[5] = { size, count, padding, 0, 0 };
+    AddEntry(path, PACK_FONT, params, table, sizeof(table));
+    AddImage(TextFormat("%s.tex", path), atlas);
+
+    UnloadImage(atlas);
+    MemFree(recs);
+    UnloadFontData(glyphs, count);
+    UnloadFileData(data);
+}
+
+// Sound effects: decoded to 16-bit PCM
+static void AddWave(const char *path){
+    Wave wave = LoadWave(path);
+    if(!wave.data){ fprintf(stderr, "packer: cannot load %s\n", path); exit(1); }
+    if(wave.sampleSize != 16) WaveFormat(&wave, wave.sampleRate, 16, wave.channels);
+    uint32_t params[5] = { wave.sampleRate, wave.sampleSize, wave.channels, wave.frameCount, 0 };
+    AddEntry(path, PACK_WAVE, params, wave.data, (size_t)wave.frameCount*wave.channels*(wave.sampleSize/8));
+    UnloadWave(wave);
+}
+
+// Streamed music: kept compressed
+static void AddStream(const char *path){
+    int size = 0;
+    unsigned char *data = LoadFileData(path, &size);
+    if(!data){ fprintf(stderr, "packer: cannot load %s\n", path); exit(1); }
+    AddEntry(path, PACK_STREAM, NULL, data, (size_t)size);
+    UnloadFileData(data);
+}
+
+// ------------------- Write -------------------
+static size_t AlignUp(size_t v){
+    return (v + PACK_ALIGN - 1) & ~(size_t)(PACK_ALIGN - 1);
+}
+
+static bool WritePack(const char *path){
+    FILE *f = fopen(path, "wb");
+    if(!f) return false;
+
+    PackHeader header = { {'W','A','M','P'}, PACK_VERSION, (uint32_t)pendingCount, 0 };
+    size_t offset = AlignUp(sizeof(header) + pendingCount*sizeof(PackEntry));
+    for(int i=0;i<pendingCount;i++){
+        pending[i].entry.offset = offset;
+        offset = AlignUp(offset + pending[i].entry.size);
+    }
+
+    static const uint8_t zeros[PACK_ALIGN] = {0};
+    fwrite(&header, sizeof(header), 1, f);
+    for(int i=0;i<pendingCount;i++) fwrite(&pending[i].entry, sizeof(PackEntry), 1, f);
+    for(int i=0;i<pendingCount;i++){
+        long pos = ftell(f);
+        fwrite(zeros, 1, pending[i].entry.offset - (size_t)pos, f);
+        fwrite(pending[i].data, 1, pending[i].entry.size, f);
+    }
+    bool ok = (ferror(f) == 0);
+    fclose(f);
+    return ok;
+}
+
+int main(int argc, char **argv){
+    const char *out = (argc > 1) ? argv[1] : "assets.pack";
+    SetTraceLogLevel(LOG_WARNING);
+
+    // Menu
+    AddFont("assets/font/myfont.ttf");
+    AddBackground("assets/visual/menu_background.png");
+    AddSpriteAtlas();
+    AddWave("assets/audio/button.wav");
+    AddStream("assets/audio/bgm.ogg");
+
+    // Game
+    AddBackground("assets/visual/game_background.png");
+    AddWave("assets/audio/mole_pop.wav");
+    AddWave("assets/audio/hit_normal.wav");
+    AddWave("assets/audio/hit_golden.wav");
+    AddWave("assets/audio/hit_bomber.wav");
+    AddWave("assets/audio/hit_empty.wav");
+    AddWave("assets/audio/victory.ogg");
+
+    if(!WritePack(out)){
+        fprintf(stderr, "packer: failed to write %s\n", out);
+        return 1;
+    }
+
+    size_t total = 0;
+    for(int i=0;i<pendingCount;i++){
+        printf("  %-40s %10llu bytes\n", pending[i].entry.name, (unsigned long long)pending[i].entry.size);
+        total += pending[i].entry.size;
+        free(pending[i].data);
+    }
+    printf("%s: %d entries, %llu payload bytes\n", out, pendingCount, (unsigned long long)total);
+    return 0;
+}
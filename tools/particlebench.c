@@ -0,0 +1,104 @@
+// Particle stress benchmark: keeps N particles alive (default 50k) in one
+// emitter and reports the update and draw cost per frame. Draw cost is the CPU
+// side of building and flushing the quad batches, measured in a hidden window;
+// --no-draw skips the window and times the update alone.
+//
+//   cc -O2 -I. tools/particlebench.c particles.c atlas.c -lraylib -lm -o particlebench
+//   ./particlebench [--particles N] [--frames N] [--no-draw]
+
+#include "particles.h"
+#include "atlas.h"
+#include "rlgl.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double NowSeconds(void){
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+static int CompareDoubles(const void *a, const void *b){
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void Report(const char *name, double *samples, int count, int particles){
+    qsort(samples, count, sizeof(double), CompareDoubles);
+    double sum = 0;
+    for(int i=0;i<count;i++) sum += samples[i];
+    double mean = sum/count;
+    printf("  %-7s mean %.3f ms  p50 %.3f ms  p95 %.3f ms  (%.1f ns/particle)\n", name,
+           mean*1e3, samples[count/2]*1e3, samples[count*95/100]*1e3, mean*1e9/particles);
+}
+
+// ------------------- Main -------------------
+int main(int argc, char **argv){
+    int particles = 50000, frames = 600;
+    bool draw = true;
+    for(int i=1;i<argc;i++){
+        if(strcmp(argv[i], "--particles") == 0 && i+1 < argc) particles = atoi(argv[++i]);
+        else if(strcmp(argv[i], "--frames") == 0 && i+1 < argc) frames = atoi(argv[++i]);
+        else if(strcmp(argv[i], "--no-draw") == 0) draw = false;
+    }
+    if(particles < 1 || frames < 1) return 1;
+
+    Texture2D dot = {0};
+    if(draw){
+        SetTraceLogLevel(LOG_WARNING);
+        SetConfigFlags(FLAG_WINDOW_HIDDEN);
+        InitWindow(1920, 1080, "particlebench");
+        Image image = GenImageGradientRadial(32, 32, 0.0f, WHITE, BLANK);
+        dot = LoadTextureFromImage(image);
+        UnloadImage(image);
+    }
+
+    // Lifetimes of 1-2 s with a burst every frame keeps the pool near full
+    ParticleEmitter e;
+    ParticleStyle style = { 100, 600, PI, 4, 12, 1.0f, 2.0f, 300, 1.0f, (Color){255, 200, 60, 255}, (Color){120, 30, 10, 255} };
+    if(!ParticleEmitterInit(&e, style, particles)) return 1;
+    const float dt = 1.0f/60.0f;
+    const int perFrame = (int)(particles*dt/1.5f) + 1;
+    for(int f=0;f<120;f++){
+        ParticleBurst(&e, 960, 540, perFrame*4);
+        ParticlesUpdate(&e, dt);
+    }
+
+    double *updateTimes = malloc(frames*sizeof(double));
+    double *drawTimes = malloc(frames*sizeof(double));
+    long long live = 0;
+    for(int f=0;f<frames;f++){
+        ParticleBurst(&e, 400 + (f*97) % 1100, 300 + (f*53) % 500, perFrame);
+        double start = NowSeconds();
+        ParticlesUpdate(&e, dt);
+        updateTimes[f] = NowSeconds() - start;
+        live += e.count;
+
+        if(draw){
+            BeginDrawing();
+            ClearBackground(BLACK);
+            RenderStatsBeginFrame();
+            start = NowSeconds();
+            ParticlesDraw(&e, dot, (Rectangle){0, 0, dot.width, dot.height});
+            rlDrawRenderBatchActive();
+            drawTimes[f] = NowSeconds() - start;
+            EndDrawing();
+        }
+    }
+
+    int meanLive = (int)(live/frames);
+    printf("particles: %d live on average (capacity %d), %d frames\n", meanLive, particles, frames);
+    Report("update", updateTimes, frames, meanLive);
+    if(draw) Report("draw", drawTimes, frames, meanLive);
+
+    free(updateTimes);
+    free(drawTimes);
+    ParticleEmitterFree(&e);
+    if(draw){
+        UnloadTexture(dot);
+        CloseWindow();
+    }
+    return 0;
+}
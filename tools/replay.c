@@ -0,0 +1,75 @@
+// Replay checker: re-runs replay files at full speed and confirms they reproduce
+// the recorded result, then times seeks and the snapshot save/load that
+// scrubbing and Resume rely on.
+//
+//   cc -O2 -I. tools/replay.c replay.c sim.c -lm -o replay
+//   ./headless --matches 1 --save-replay match.replay
+//   ./replay match.replay [more.replay ...]
+
+#include "replay.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// ------------------- Timing -------------------
+static double NowSeconds(void){
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+// ------------------- Main -------------------
+int main(int argc, char **argv){
+    if(argc < 2){
+        fprintf(stderr, "usage: %s FILE.replay [...]\n", argv[0]);
+        return 1;
+    }
+
+    int failed = 0;
+    for(int i=1;i<argc;i++){
+        static Replay replay;
+        static Match match;
+        ReplayPlayer player;
+        if(!ReplayLoad(&replay, argv[i])){ failed++; continue; }
+
+        double start = NowSeconds();
+        if(!ReplayPlayerInit(&player, &replay, &match)){ failed++; continue; }
+        double runTime = NowSeconds() - start;
+        double matchTime = player.endTick*(double)SIM_DT;
+
+        printf("%s: seed %llu  %d teams  %d holes  %d hits  %u ticks\n", argv[i],
+               (unsigned long long)replay.seed, replay.teamCount, replay.board.holeCount, replay.hitCount, player.endTick);
+        printf("  result:");
+        ReplayPlayerSeek(&player, player.endTick);
+        for(int t=0;t<replay.teamCount;t++) printf(" %d", match.scores[t]);
+        printf("  %s\n", !replay.finished ? "(unfinished recording)" : player.verified ? "verified" : "MISMATCH");
+        printf("  full run with keyframes: %.2f ms (%.0fx real time)\n", runTime*1000.0, runTime > 0 ? matchTime/runTime : 0.0);
+        if(replay.finished && !player.verified) failed++;
+
+        // Scrubbing: random seeks, each a keyframe load plus at most one interval of ticks
+        SimRng rng;
+        SimRngSeed(&rng, 1, 1);
+        const int seeks = 200;
+        start = NowSeconds();
+        for(int k=0;k<seeks;k++) ReplayPlayerSeek(&player, (uint32_t)SimRngRange(&rng, 0, (int)player.endTick));
+        printf("  random seek: %.1f us average\n", (NowSeconds() - start)/seeks*1e6);
+
+        // Snapshot cost, from the middle of the match
+        ReplayPlayerSeek(&player, player.endTick/2);
+        uint8_t *buf = malloc(SimSnapshotSize(&match));
+        size_t size = SimSnapshotSize(&match);
+        const int reps = 100000;
+        start = NowSeconds();
+        for(int k=0;k<reps;k++) SimSave(&match, buf, size);
+        double saveTime = (NowSeconds() - start)/reps;
+        start = NowSeconds();
+        for(int k=0;k<reps;k++) SimLoad(&match, buf, size);
+        double loadTime = (NowSeconds() - start)/reps;
+        printf("  snapshot: %zu bytes, save %.2f us, load %.2f us\n", size, saveTime*1e6, loadTime*1e6);
+        free(buf);
+
+        ReplayPlayerFree(&player);
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,62 @@
+// Dedicated LAN server: owns the match, clients join with --connect.
+// Starts when every team has joined and begins a new match 5 s after each round.
+//
+//   cc -O2 -I. tools/server.c net.c sim.c -lm -o server
+//   ./server --port 7777 --teams 2 [--latency ms] [--jitter ms] [--loss pct]
+
+#if !defined(_WIN32)
+    #define _POSIX_C_SOURCE 200112L     // nanosleep under -std=c11
+#endif
+#include "net.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(_WIN32)
+    void __stdcall Sleep(unsigned long ms);
+#endif
+
+// ------------------- Timing -------------------
+static double NowSeconds(void){
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+static void SleepMs(int ms){
+#if defined(_WIN32)
+    Sleep((unsigned long)ms);
+#else
+    struct timespec ts = { 0, ms*1000000L };
+    nanosleep(&ts, NULL);
+#endif
+}
+
+// ------------------- Main -------------------
+int main(int argc, char **argv){
+    int port = NET_DEFAULT_PORT, teams = 2;
+    NetConditions conditions = {0};
+
+    for(int i=1;i<argc;i++){
+        if(!strcmp(argv[i], "--port") && i+1<argc) port = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--teams") && i+1<argc) teams = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--latency") && i+1<argc) conditions.latency = atof(argv[++i])/1000.0;
+        else if(!strcmp(argv[i], "--jitter") && i+1<argc) conditions.jitter = atof(argv[++i])/1000.0;
+        else if(!strcmp(argv[i], "--loss") && i+1<argc) conditions.loss = (float)atof(argv[++i])/100.0f;
+        else{
+            fprintf(stderr, "usage: %s [--port N] [--teams N] [--latency ms] [--jitter ms] [--loss pct]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    static NetServer server;
+    if(!NetServerStart(&server, (uint16_t)port, teams, &conditions)) return 1;
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    // 1 ms sleeps keep the tick clock tight without spinning a core
+    double start = NowSeconds();
+    for(;;){
+        NetServerUpdate(&server, NowSeconds() - start);
+        SleepMs(1);
+    }
+}
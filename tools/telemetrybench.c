@@ -0,0 +1,109 @@
+// Telemetry push benchmark: the cost the game thread pays per TelemetryPush().
+// Pushes bursts of events (default 600 bursts of 256, far more than a frame of
+// play raises, one 60 Hz frame apart) while the writer drains to a scratch log,
+// and reports ns per push over the bursts. Then pushes faster than the
+// writer can keep up, to time the full-ring (drop) path too.
+//
+//   cc -O2 -I. tools/telemetrybench.c telemetry.c -lpthread -o telemetrybench
+//   ./telemetrybench [--bursts N] [--burst N] [--gap-us N] [--path F] [--keep]
+
+#include "telemetry.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double NowSeconds(void){
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+static void WaitSeconds(double seconds){
+    for(double until = NowSeconds() + seconds; NowSeconds() < until;){}
+}
+
+static int CompareDoubles(const void *a, const void *b){
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void RemoveFiles(const char *path){
+    char other[300];
+    remove(path);
+    for(int i=1;i<=TELEMETRY_KEEP_FILES;i++){
+        snprintf(other, sizeof(other), "%s.%d", path, i);
+        remove(other);
+    }
+}
+
+// A hit on a rotating hole, as the game sends them
+static void PushBurst(TelemetryEvent *ev, int count){
+    for(int i=0;i<count;i++){
+        ev->tick++;
+        ev->hole = (int16_t)(ev->tick % 5);
+        TelemetryPush(ev);
+    }
+}
+
+// ------------------- Main -------------------
+int main(int argc, char **argv){
+    int bursts = 600, burst = 256, gapUs = 16667;
+    const char *path = "telemetrybench.ndjson";
+    bool keep = false;
+    for(int i=1;i<argc;i++){
+        if(strcmp(argv[i], "--bursts") == 0 && i+1 < argc) bursts = atoi(argv[++i]);
+        else if(strcmp(argv[i], "--burst") == 0 && i+1 < argc) burst = atoi(argv[++i]);
+        else if(strcmp(argv[i], "--gap-us") == 0 && i+1 < argc) gapUs = atoi(argv[++i]);
+        else if(strcmp(argv[i], "--path") == 0 && i+1 < argc) path = argv[++i];
+        else if(strcmp(argv[i], "--keep") == 0) keep = true;
+    }
+    if(bursts < 1 || burst < 1 || burst > TELEMETRY_RING || gapUs < 0) return 1;
+
+    RemoveFiles(path);
+    if(!TelemetryOpen(path)) return 1;
+    TelemetryEvent ev = { .match = 1, .type = TEL_HIT, .team = 0, .moleType = 1, .value = 350, .score = 10 };
+
+    // ------------------- Bursts -------------------
+    // Timed per burst: a clock read per push would cost more than the push
+    double *perPush = malloc(bursts*sizeof(double));
+    double total = 0;
+    for(int b=0;b<bursts;b++){
+        double start = NowSeconds();
+        PushBurst(&ev, burst);
+        double spent = NowSeconds() - start;
+        perPush[b] = spent*1e9/burst;
+        total += spent;
+        WaitSeconds(gapUs*1e-6);
+    }
+    qsort(perPush, bursts, sizeof(double), CompareDoubles);
+    TelemetryStats drained = TelemetryGetStats();
+    printf("push:      %.1f ns mean, p50 %.1f, p99 %.1f, max %.1f  (%d bursts of %d, %d us apart, %llu dropped)\n",
+           total*1e9/((double)bursts*burst), perPush[bursts/2], perPush[bursts*99/100], perPush[bursts - 1],
+           bursts, burst, gapUs, (unsigned long long)drained.dropped);
+    free(perPush);
+
+    // ------------------- Full Ring -------------------
+    // Faster than the writer can go: most of these find the ring full
+    const int flood = 8*TELEMETRY_RING;
+    double start = NowSeconds();
+    PushBurst(&ev, flood);
+    double spent = NowSeconds() - start;
+    TelemetryStats flooded = TelemetryGetStats();
+    printf("flood:     %.1f ns per push, %llu of %d dropped\n", spent*1e9/flood,
+           (unsigned long long)(flooded.dropped - drained.dropped), flood);
+
+    TelemetryClose();
+    TelemetryStats s = TelemetryGetStats();
+    printf("writer:    %llu pushed, %llu dropped, %llu lines written, %llu lost, %d rotations\n",
+           (unsigned long long)s.pushed, (unsigned long long)s.dropped, (unsigned long long)s.written,
+           (unsigned long long)s.lost, s.rotations);
+
+    // ------------------- Checks -------------------
+    // Every push was either queued or counted as dropped, and every queued one written
+    bool ok = s.pushed + s.dropped == (uint64_t)bursts*burst + flood && s.lost == 0
+           && s.written >= s.pushed && s.written <= s.pushed + s.dropped;
+    printf("%s\n", ok ? "checks passed" : "CHECKS FAILED");
+    if(!keep) RemoveFiles(path);
+    return ok ? 0 : 1;
+}
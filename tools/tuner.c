@@ -0,0 +1,440 @@
+// Rules tuner: plays many bot matches for every combination of the rule values
+// given with --vary, on a work-stealing thread pool, and reports how close and
+// how swingy the matches are under each rule set.
+//
+//   cc -O2 -I. tools/tuner.c sim.c -lm -lpthread -o tuner
+//   ./tuner --matches 20000 --vary golden=0,5,10 --vary lifetime=0.8,1,1.2
+//   ./tuner --bot0 normal:0.45:0.12 --bot1 lognormal:0.6:0.4:0.5 --threads 8
+//   ./tuner --scaling          the same sweep on 1, 2, 4... threads
+//
+// Rule names: normal golden bomber empty (spawn weights), lifetime, idle (mean
+// seconds between moles in a hole), pnormal pgolden pbomber pempty miss (points).
+// Bots: uniform:MIN:MAX, normal:MEAN:SD or lognormal:MEDIAN:SIGMA reaction
+// times in seconds, then optionally :AVOID, the chance of sparing a bomber or
+// empty mole. Results depend only on --seed, never on the thread count.
+
+#if !defined(_WIN32)
+    #define _POSIX_C_SOURCE 200112L     // sysconf under -std=c11
+    #include <unistd.h>
+#endif
+#include "sim.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_SETS 4096
+#define MAX_AXES 8
+#define MAX_THREADS 64
+#define CHUNK_MATCHES 250       // matches per task
+
+// ------------------- Rule Sets -------------------
+typedef struct {
+    SimRules rules;
+    float idle;
+    char label[MAX_AXES*32];    // the varied values: " name=value" is at most 1 + 15 + 1 + 12 (%g of a float)
+} RuleSet;
+
+static bool SetRule(RuleSet *set, const char *name, float v){
+    SimRules *r = &set->rules;
+    if(!strcmp(name, "normal")) r->spawnWeight[MOLE_NORMAL] = (int)v;
+    else if(!strcmp(name, "golden")) r->spawnWeight[MOLE_GOLDEN] = (int)v;
+    else if(!strcmp(name, "bomber")) r->spawnWeight[MOLE_BOMBER] = (int)v;
+    else if(!strcmp(name, "empty")) r->spawnWeight[MOLE_EMPTY] = (int)v;
+    else if(!strcmp(name, "lifetime") && v > 0) r->moleLifetime = v;
+    else if(!strcmp(name, "idle") && v > 0) set->idle = v;
+    else if(!strcmp(name, "pnormal")) r->points[MOLE_NORMAL] = (int)v;
+    else if(!strcmp(name, "pgolden")) r->points[MOLE_GOLDEN] = (int)v;
+    else if(!strcmp(name, "pbomber")) r->points[MOLE_BOMBER] = (int)v;
+    else if(!strcmp(name, "pempty")) r->points[MOLE_EMPTY] = (int)v;
+    else if(!strcmp(name, "miss")) r->missPoints = (int)v;
+    else return false;
+    return true;
+}
+
+// ------------------- Bot Players -------------------
+typedef enum { REACT_UNIFORM, REACT_NORMAL, REACT_LOGNORMAL } ReactionKind;
+
+typedef struct {
+    ReactionKind kind;
+    float a, b;
+    float avoid;        // chance of sparing a bomber/empty mole
+} BotProfile;
+
+typedef struct {
+    const BotProfile *profile;
+    SimRng rng;
+    uint64_t up[SIM_MAX_HOLES/64];      // holes with a mole at the last poll
+    uint32_t strikeTick[SIM_MAX_HOLES];
+} Bot;
+
+static bool ParseProfile(BotProfile *p, const char *spec){
+    char kind[16];
+    float avoid = 0.7f;
+    int n = sscanf(spec, "%15[a-z]:%f:%f:%f", kind, &p->a, &p->b, &avoid);
+    if(n < 3) return false;
+    if(!strcmp(kind, "uniform")) p->kind = REACT_UNIFORM;
+    else if(!strcmp(kind, "normal")) p->kind = REACT_NORMAL;
+    else if(!strcmp(kind, "lognormal")) p->kind = REACT_LOGNORMAL;
+    else return false;
+    p->avoid = avoid;
+    return true;
+}
+
+static float Gaussian(SimRng *rng){
+    float u1 = 1.0f - SimRngFloat(rng), u2 = SimRngFloat(rng);
+    return sqrtf(-2.0f*logf(u1))*cosf(6.2831853f*u2);
+}
+
+// Seconds from pop to strike; nobody reacts faster than 100 ms
+static float DrawReaction(const BotProfile *p, SimRng *rng){
+    float t;
+    switch(p->kind){
+        case REACT_NORMAL: t = p->a + p->b*Gaussian(rng); break;
+        case REACT_LOGNORMAL: t = p->a*expf(p->b*Gaussian(rng)); break;
+        default: t = p->a + (p->b - p->a)*SimRngFloat(rng); break;
+    }
+    return t < 0.1f ? 0.1f : t;
+}
+
+static void BotThink(Bot *bot, const Match *match, SimInput *input, int team){
+    const SimMoles *m = &match->moles;
+    for(int k=0;k<m->activeCount;k++){
+        int i = m->activeHole[k];
+        if(!((bot->up[i >> 6] >> (i & 63)) & 1u)){
+            // Hole was empty at the last poll: a new mole
+            bool bad = (m->type[i] == MOLE_BOMBER || m->type[i] == MOLE_EMPTY);
+            if(bad && SimRngFloat(&bot->rng) < bot->profile->avoid) bot->strikeTick[i] = UINT32_MAX;
+            else bot->strikeTick[i] = match->tick + (uint32_t)(DrawReaction(bot->profile, &bot->rng)*SIM_TICK_HZ);
+        }
+        if(!SimMoleHit(m, i) && match->tick >= bot->strikeTick[i]){
+            SimInputAdd(input, i, team);
+            bot->strikeTick[i] = UINT32_MAX;
+        }
+    }
+    // The whole visible set, so an emptied hole reads as empty next poll and its next mole gets a fresh strike time
+    memcpy(bot->up, m->visible, ((size_t)match->board->holeCount + 63)/64*sizeof(uint64_t));
+}
+
+// ------------------- Tasks -------------------
+typedef struct { int set, chunk; } Task;
+
+typedef struct {
+    long matches, draws, team0Wins;
+    long comebacks, ledAtHalf;      // trailing at half time and still winning
+    double sumTotal, sumAbsDiff, sumDiff2;
+} Result;
+
+// Owner pops at the tail, thieves take from the head
+typedef struct {
+    pthread_mutex_t lock;
+    Task *tasks;
+    int head, tail;
+} Deque;
+
+typedef struct {
+    int id;
+    pthread_t thread;
+    Deque deque;
+    SimRng rng;             // reseeded from the task id for every task
+    SimRng stealRng;        // picks victims
+    long tasksRun, steals;
+    Match match;
+    SimBoard board;
+    Bot bots[2];
+} Worker;
+
+static struct {
+    const RuleSet *sets;
+    int setCount, chunksPerSet;
+    long matchesPerSet;
+    uint64_t seed;
+    BotProfile profiles[2];
+    Result *results;        // by task id, reduced in order afterwards
+    Worker *workers;
+    int workerCount;
+} pool;
+
+static bool PopOwn(Worker *w, Task *task){
+    pthread_mutex_lock(&w->deque.lock);
+    bool ok = w->deque.tail > w->deque.head;
+    if(ok) *task = w->deque.tasks[--w->deque.tail];
+    pthread_mutex_unlock(&w->deque.lock);
+    return ok;
+}
+
+static bool Steal(Worker *w, Task *task){
+    int start = (int)(SimRngNext(&w->stealRng) % (uint32_t)pool.workerCount);
+    for(int k=0;k<pool.workerCount;k++){
+        Worker *victim = &pool.workers[(start + k) % pool.workerCount];
+        if(victim == w) continue;
+        pthread_mutex_lock(&victim->deque.lock);
+        bool ok = victim->deque.tail > victim->deque.head;
+        if(ok) *task = victim->deque.tasks[victim->deque.head++];
+        pthread_mutex_unlock(&victim->deque.lock);
+        if(ok){ w->steals++; return true; }
+    }
+    return false;
+}
+
+static void RunTask(Worker *w, Task task){
+    const RuleSet *set = &pool.sets[task.set];
+    int id = task.set*pool.chunksPerSet + task.chunk;
+    Result *res = &pool.results[id];
+    memset(res, 0, sizeof(*res));
+    SimRngSeed(&w->rng, pool.seed, (uint64_t)id + 1);
+
+    w->board = simDefaultBoard;
+    w->board.spawnMeanIdle = set->idle;
+    long first = (long)task.chunk*CHUNK_MATCHES;
+    long count = pool.matchesPerSet - first < CHUNK_MATCHES ? pool.matchesPerSet - first : CHUNK_MATCHES;
+    const uint32_t halfTick = (uint32_t)(roundTime*SIM_TICK_HZ/2);
+
+    for(long n=0;n<count;n++){
+        uint64_t matchSeed = ((uint64_t)SimRngNext(&w->rng) << 32) | SimRngNext(&w->rng);
+        Match *match = &w->match;
+        match->board = &w->board;
+        match->rules = &set->rules;
+        match->teamCount = 2;
+        SimInit(match, matchSeed);
+        for(int t=0;t<2;t++){
+            Bot *bot = &w->bots[t];
+            bot->profile = &pool.profiles[t];
+            SimRngSeed(&bot->rng, matchSeed, (uint64_t)t + 1);
+            memset(bot->up, 0, sizeof(bot->up));
+        }
+
+        // Only the first hit on a mole scores, so which bot's hits go first is a coin flip each tick
+        SimRng order;
+        SimRngSeed(&order, matchSeed, 3);
+        int halfLeader = -1;
+        SimInput input;
+        while(!SimIsOver(match)){
+            input.count = 0;
+            int first = (int)(SimRngNext(&order) & 1);
+            BotThink(&w->bots[first], match, &input, first);
+            BotThink(&w->bots[1 - first], match, &input, 1 - first);
+            SimStep(match, &input);
+            if(match->tick == halfTick) halfLeader = SimWinner(match);
+        }
+
+        int winner = SimWinner(match);
+        int diff = match->scores[0] - match->scores[1];
+        res->matches++;
+        res->draws += winner < 0;
+        res->team0Wins += winner == 0;
+        if(halfLeader >= 0){
+            res->ledAtHalf++;
+            res->comebacks += (winner >= 0 && winner != halfLeader);
+        }
+        res->sumTotal += match->scores[0] + match->scores[1];
+        res->sumAbsDiff += abs(diff);
+        res->sumDiff2 += (double)diff*diff;
+    }
+    w->tasksRun++;
+}
+
+static void *WorkerMain(void *arg){
+    Worker *w = arg;
+    Task task;
+    // Nothing is added once running, so empty everywhere means done
+    while(PopOwn(w, &task) || Steal(w, &task)) RunTask(w, task);
+    return NULL;
+}
+
+// Tasks go out in contiguous blocks; stealing evens out the rest
+static double RunPool(int threads){
+    int taskCount = pool.setCount*pool.chunksPerSet;
+    pool.workerCount = threads;
+    for(int i=0;i<threads;i++){
+        Worker *w = &pool.workers[i];
+        w->id = i;
+        w->tasksRun = w->steals = 0;
+        SimRngSeed(&w->stealRng, 7, (uint64_t)i);
+        pthread_mutex_init(&w->deque.lock, NULL);
+        int from = (int)((long)taskCount*i/threads), to = (int)((long)taskCount*(i + 1)/threads);
+        w->deque.head = 0;
+        w->deque.tail = to - from;
+        // Reversed, so the owner's pops go through its block in order
+        for(int k=from;k<to;k++) w->deque.tasks[to - 1 - k] = (Task){ k/pool.chunksPerSet, k % pool.chunksPerSet };
+    }
+
+    struct timespec t0, t1;
+    timespec_get(&t0, TIME_UTC);
+    for(int i=0;i<threads;i++) pthread_create(&pool.workers[i].thread, NULL, WorkerMain, &pool.workers[i]);
+    for(int i=0;i<threads;i++) pthread_join(pool.workers[i].thread, NULL);
+    timespec_get(&t1, TIME_UTC);
+    for(int i=0;i<threads;i++){
+        pthread_mutex_destroy(&pool.workers[i].deque.lock);
+        SimFree(&pool.workers[i].match);
+    }
+    return (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec)*1e-9;
+}
+
+// ------------------- Setup -------------------
+static int CoreCount(void){
+#if defined(_WIN32)
+    const char *env = getenv("NUMBER_OF_PROCESSORS");
+    int n = env ? atoi(env) : 0;
+#else
+    int n = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return n > 0 ? n : 1;
+}
+
+typedef struct {
+    char name[16];
+    float values[32];
+    int count;
+} Axis;
+
+static bool ParseAxis(Axis *axis, const char *spec){
+    const char *eq = strchr(spec, '=');
+    if(!eq || eq - spec >= (int)sizeof(axis->name)) return false;
+    memcpy(axis->name, spec, (size_t)(eq - spec));
+    axis->name[eq - spec] = '\0';
+    axis->count = 0;
+    for(const char *p = eq + 1;*p && axis->count < 32;){
+        char *end;
+        axis->values[axis->count++] = strtof(p, &end);
+        if(end == p) return false;
+        p = (*end == ',') ? end + 1 : end;
+    }
+    RuleSet probe = {0};
+    return axis->count > 0 && SetRule(&probe, axis->name, 1.0f);
+}
+
+// Every combination of the axes, last axis varying fastest
+static int ExpandSets(RuleSet *sets, const Axis *axes, int axisCount){
+    int total = 1;
+    for(int a=0;a<axisCount;a++) total *= axes[a].count;
+    if(total > MAX_SETS) return -1;
+    for(int s=0;s<total;s++){
+        RuleSet *set = &sets[s];
+        set->rules = simDefaultRules;
+        set->idle = simDefaultBoard.spawnMeanIdle;
+        int rest = s;
+        for(int a=axisCount-1;a>=0;a--){
+            float v = axes[a].values[rest % axes[a].count];
+            rest /= axes[a].count;
+            SetRule(set, axes[a].name, v);
+        }
+        // Each piece fits its share of the label (see RuleSet), so nothing is cut
+        int len = 0;
+        for(int a=0;a<axisCount;a++){
+            int idx = s;
+            for(int b=axisCount-1;b>a;b--) idx /= axes[b].count;
+            char piece[32];
+            int n = snprintf(piece, sizeof(piece), "%s%.15s=%g", a ? " " : "", axes[a].name, axes[a].values[idx % axes[a].count]);
+            memcpy(set->label + len, piece, (size_t)n);
+            len += n;
+        }
+        set->label[len] = '\0';
+        if(!axisCount) strcpy(set->label, "defaults");
+    }
+    return total;
+}
+
+// ------------------- Main -------------------
+int main(int argc, char **argv){
+    static RuleSet sets[MAX_SETS];
+    Axis axes[MAX_AXES];
+    int axisCount = 0, threads = CoreCount();
+    bool scaling = false;
+    pool.matchesPerSet = 10000;
+    pool.seed = 1;
+    pool.profiles[0] = (BotProfile){ REACT_UNIFORM, 0.25f, 0.9f, 0.7f };    // headless.c's bots
+    pool.profiles[1] = pool.profiles[0];
+
+    for(int i=1;i<argc;i++){
+        if(!strcmp(argv[i], "--matches") && i+1<argc) pool.matchesPerSet = strtol(argv[++i], NULL, 10);
+        else if(!strcmp(argv[i], "--seed") && i+1<argc) pool.seed = strtoull(argv[++i], NULL, 10);
+        else if(!strcmp(argv[i], "--threads") && i+1<argc) threads = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--scaling")) scaling = true;
+        else if(!strcmp(argv[i], "--vary") && i+1<argc && axisCount < MAX_AXES && ParseAxis(&axes[axisCount], argv[i+1])){ axisCount++; i++; }
+        else if(!strcmp(argv[i], "--bot0") && i+1<argc && ParseProfile(&pool.profiles[0], argv[i+1])) i++;
+        else if(!strcmp(argv[i], "--bot1") && i+1<argc && ParseProfile(&pool.profiles[1], argv[i+1])) i++;
+        else{
+            fprintf(stderr, "usage: %s [--matches N] [--seed S] [--threads N] [--scaling]\n"
+                            "       [--vary NAME=V1,V2,...]... [--bot0 KIND:A:B[:AVOID]] [--bot1 ...]\n", argv[0]);
+            return 1;
+        }
+    }
+    if(threads < 1) threads = 1;
+    if(threads > MAX_THREADS) threads = MAX_THREADS;
+    if(pool.matchesPerSet < 1) pool.matchesPerSet = 1;
+
+    pool.setCount = ExpandSets(sets, axes, axisCount);
+    if(pool.setCount < 0){
+        fprintf(stderr, "more than %d rule sets\n", MAX_SETS);
+        return 1;
+    }
+    pool.sets = sets;
+    pool.chunksPerSet = (int)((pool.matchesPerSet + CHUNK_MATCHES - 1)/CHUNK_MATCHES);
+    int taskCount = pool.setCount*pool.chunksPerSet;
+    pool.results = calloc((size_t)taskCount, sizeof(Result));
+    pool.workers = calloc(MAX_THREADS, sizeof(Worker));
+    for(int i=0;i<MAX_THREADS && pool.workers;i++) pool.workers[i].deque.tasks = malloc((size_t)taskCount*sizeof(Task));
+    if(!pool.results || !pool.workers){
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    long totalMatches = pool.matchesPerSet*pool.setCount;
+    printf("%d rule set(s) x %ld matches, %d task(s) of up to %d\n", pool.setCount, pool.matchesPerSet, taskCount, CHUNK_MATCHES);
+
+    // Scaling: same work on more and more threads; the results must not change
+    if(scaling){
+        double base = 0;
+        uint64_t firstSum = 0;
+        for(int t=1;t<=threads;t = (t*2 > threads && t != threads) ? threads : t*2){
+            double elapsed = RunPool(t);
+            uint64_t sum = 1469598103934665603ULL;
+            for(int k=0;k<taskCount;k++){
+                sum ^= (uint64_t)pool.results[k].team0Wins*31 + (uint64_t)pool.results[k].sumAbsDiff;
+                sum *= 1099511628211ULL;
+            }
+            if(t == 1){ base = elapsed; firstSum = sum; }
+            long steals = 0;
+            for(int i=0;i<t;i++) steals += pool.workers[i].steals;
+            printf("threads %2d: %7.3f s  %8.0f matches/s  speedup %.2fx  efficiency %3.0f%%  steals %ld  %s\n",
+                   t, elapsed, totalMatches/elapsed, base/elapsed, 100.0*base/elapsed/t, steals,
+                   sum == firstSum ? "same results" : "RESULTS DIFFER");
+            if(t == threads) break;
+        }
+    }else{
+        double elapsed = RunPool(threads);
+        long steals = 0;
+        for(int i=0;i<threads;i++) steals += pool.workers[i].steals;
+        printf("%d thread(s): %.3f s, %.0f matches/s, %ld steal(s)\n", threads, elapsed, totalMatches/elapsed, steals);
+    }
+
+    // Per rule set, reduced in task order so the sums don't depend on scheduling
+    printf("\n%-44s %8s %8s %8s %7s %9s %8s\n", "rules", "points", "|diff|", "diff sd", "draws", "comeback", "p0 wins");
+    for(int s=0;s<pool.setCount;s++){
+        Result sum = {0};
+        for(int c=0;c<pool.chunksPerSet;c++){
+            const Result *r = &pool.results[s*pool.chunksPerSet + c];
+            sum.matches += r->matches;
+            sum.draws += r->draws;
+            sum.team0Wins += r->team0Wins;
+            sum.comebacks += r->comebacks;
+            sum.ledAtHalf += r->ledAtHalf;
+            sum.sumTotal += r->sumTotal;
+            sum.sumAbsDiff += r->sumAbsDiff;
+            sum.sumDiff2 += r->sumDiff2;
+        }
+        double n = (double)sum.matches;
+        printf("%-44s %8.1f %8.1f %8.1f %6.2f%% %8.2f%% %7.2f%%\n", sets[s].label,
+               sum.sumTotal/n, sum.sumAbsDiff/n, sqrt(sum.sumDiff2/n),
+               100.0*sum.draws/n, sum.ledAtHalf ? 100.0*sum.comebacks/sum.ledAtHalf : 0.0, 100.0*sum.team0Wins/n);
+    }
+
+    for(int i=0;i<MAX_THREADS;i++) free(pool.workers[i].deque.tasks);
+    free(pool.workers);
+    free(pool.results);
+    return 0;
+}